@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Structure-of-arrays views used by the batch kernels. Each member points at
+// `count` contiguous floats owned by the caller. Kernels read and write
+// through these pointers; they never allocate or take ownership.
+
+
+struct VecSoA
+{
+    float* x;
+    float* y;
+    float* z;
+};
+
+
+struct BiVectorSoA
+{
+    float* e12;
+    float* e13;
+    float* e23;
+};
+
+
+struct RotorSoA
+{
+    float* s;
+    float* e12;
+    float* e13;
+    float* e23;
+};
+
+
+// Returns the number of worker threads to use for a requested count.
+// 0 means one per hardware thread.
+inline int
+Batch_ThreadCount(int requested)
+{
+    if (requested > 0)
+    {
+        return requested;
+    }
+    auto hw = (int)std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+
+// Splits [0, count) into one contiguous range per thread and calls
+// fn(begin, end) for each. Ranges are multiples of `grain` (except the last)
+// so SIMD loops only see a tail at the very end. Partitioning depends only
+// on count, grain and thread_count, so results are reproducible run to run.
+// The calling thread processes the first range.
+template <typename Fn>
+void
+Batch_ParallelFor(size_t count, size_t grain, int thread_count, Fn&& fn)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    size_t threads = (size_t)Batch_ThreadCount(thread_count);
+    size_t blocks  = (count + grain - 1) / grain;
+    if (threads > blocks)
+    {
+        threads = blocks;
+    }
+
+    if (threads <= 1)
+    {
+        fn((size_t)0, count);
+        return;
+    }
+
+    size_t per_thread = (blocks + threads - 1) / threads * grain;
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t)
+    {
+        size_t begin = t * per_thread;
+        size_t end   = begin + per_thread < count ? begin + per_thread : count;
+        if (begin >= end)
+        {
+            break;
+        }
+        workers.emplace_back([&fn, begin, end]() { fn(begin, end); });
+    }
+
+    fn((size_t)0, per_thread < count ? per_thread : count);
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
@@ -0,0 +1,214 @@
+#include "GeometricAlgebra/batch_ops.h"
+#include "GeometricAlgebra/cpu_dispatch.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GA_X86 1
+#include <immintrin.h>
+#endif
+
+// Every path is compiled into this one translation unit from the same
+// kernel bodies (batch_ops_kernels.inl). The vector paths are built with
+// target pragmas, so the library itself needs no -m flags and still runs on
+// machines without AVX.
+
+
+// Scalar path. Also finishes the tail for the vector paths.
+#define V            float
+#define V_WIDTH      1
+#define V_LOAD(p)    (*(p))
+#define V_STORE(p, v) (*(p) = (v))
+#define V_SET1(x)    (x)
+#define V_ADD(a, b)  ((a) + (b))
+#define V_SUB(a, b)  ((a) - (b))
+#define V_MUL(a, b)  ((a) * (b))
+#define V_DIV(a, b)  ((a) / (b))
+#define V_SQRT(a)    sqrtf(a)
+#define V_LT(a, b)   ((a) < (b))
+#define V_SELECT(m, a, b) ((m) ? (a) : (b))
+#define KERNEL(name) name##_Scalar
+#include "GeometricAlgebra/batch_ops_kernels.inl"
+#undef V
+#undef V_WIDTH
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_LT
+#undef V_SELECT
+#undef KERNEL
+
+
+#if defined(GA_X86)
+
+GA_TARGET_BEGIN("sse4.1")
+#define V            __m128
+#define V_WIDTH      4
+#define V_LOAD(p)    _mm_loadu_ps(p)
+#define V_STORE(p, v) _mm_storeu_ps(p, v)
+#define V_SET1(x)    _mm_set1_ps(x)
+#define V_ADD(a, b)  _mm_add_ps(a, b)
+#define V_SUB(a, b)  _mm_sub_ps(a, b)
+#define V_MUL(a, b)  _mm_mul_ps(a, b)
+#define V_DIV(a, b)  _mm_div_ps(a, b)
+#define V_SQRT(a)    _mm_sqrt_ps(a)
+#define V_LT(a, b)   _mm_cmplt_ps(a, b)
+#define V_SELECT(m, a, b) _mm_blendv_ps(b, a, m)
+#define KERNEL(name) name##_SSE4
+#include "GeometricAlgebra/batch_ops_kernels.inl"
+#undef V
+#undef V_WIDTH
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_LT
+#undef V_SELECT
+#undef KERNEL
+GA_TARGET_END
+
+
+GA_TARGET_BEGIN("avx2")
+#define V            __m256
+#define V_WIDTH      8
+#define V_LOAD(p)    _mm256_loadu_ps(p)
+#define V_STORE(p, v) _mm256_storeu_ps(p, v)
+#define V_SET1(x)    _mm256_set1_ps(x)
+#define V_ADD(a, b)  _mm256_add_ps(a, b)
+#define V_SUB(a, b)  _mm256_sub_ps(a, b)
+#define V_MUL(a, b)  _mm256_mul_ps(a, b)
+#define V_DIV(a, b)  _mm256_div_ps(a, b)
+#define V_SQRT(a)    _mm256_sqrt_ps(a)
+#define V_LT(a, b)   _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define V_SELECT(m, a, b) _mm256_blendv_ps(b, a, m)
+#define KERNEL(name) name##_AVX2
+#include "GeometricAlgebra/batch_ops_kernels.inl"
+#undef V
+#undef V_WIDTH
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_LT
+#undef V_SELECT
+#undef KERNEL
+GA_TARGET_END
+
+
+GA_TARGET_BEGIN("avx512f")
+#define V            __m512
+#define V_WIDTH      16
+#define V_LOAD(p)    _mm512_loadu_ps(p)
+#define V_STORE(p, v) _mm512_storeu_ps(p, v)
+#define V_SET1(x)    _mm512_set1_ps(x)
+#define V_ADD(a, b)  _mm512_add_ps(a, b)
+#define V_SUB(a, b)  _mm512_sub_ps(a, b)
+#define V_MUL(a, b)  _mm512_mul_ps(a, b)
+#define V_DIV(a, b)  _mm512_div_ps(a, b)
+// The unmasked form trips -Wmaybe-uninitialized inside GCC's own header.
+#define V_SQRT(a)    _mm512_mask_sqrt_ps(a, (__mmask16)0xFFFF, a)
+#define V_LT(a, b)   _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ)
+#define V_SELECT(m, a, b) _mm512_mask_blend_ps(m, b, a)
+#define KERNEL(name) name##_AVX512
+#include "GeometricAlgebra/batch_ops_kernels.inl"
+#undef V
+#undef V_WIDTH
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_LT
+#undef V_SELECT
+#undef KERNEL
+GA_TARGET_END
+
+#endif
+
+
+// Picks the kernel for the active path, runs it on [begin, end), then
+// finishes any tail with the scalar kernel. `args` are forwarded to both.
+#if defined(GA_X86)
+#define DISPATCH(name, begin, end, ...)                                \
+    do                                                                 \
+    {                                                                  \
+        size_t i_ = begin;                                             \
+        switch (Cpu_ActivePath())                                      \
+        {                                                              \
+        case CpuPath_AVX512:                                           \
+            i_ = name##_AVX512(__VA_ARGS__, i_, end);                  \
+            break;                                                     \
+        case CpuPath_AVX2:                                             \
+            i_ = name##_AVX2(__VA_ARGS__, i_, end);                    \
+            break;                                                     \
+        case CpuPath_SSE4:                                             \
+            i_ = name##_SSE4(__VA_ARGS__, i_, end);                    \
+            break;                                                     \
+        default:                                                       \
+            break;                                                     \
+        }                                                              \
+        name##_Scalar(__VA_ARGS__, i_, end);                           \
+    } while (0)
+#else
+#define DISPATCH(name, begin, end, ...) name##_Scalar(__VA_ARGS__, begin, end)
+#endif
+
+
+void
+Batch_Rotate(RotorSoA const& R, VecSoA const& v, VecSoA const& out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        DISPATCH(Rotate, begin, end, R, v, out);
+    });
+}
+
+
+void
+Batch_GeoMul(RotorSoA const& X, RotorSoA const& Y, RotorSoA const& out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        DISPATCH(GeoMul, begin, end, X, Y, out);
+    });
+}
+
+
+void
+Batch_ToMatrix4(RotorSoA const& R, Matrix4* out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        DISPATCH(ToMatrix4, begin, end, R, out);
+    });
+}
+
+
+void
+Batch_Normalise(RotorSoA const& R, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        DISPATCH(Normalise, begin, end, R);
+    });
+}
+
+
+void
+Batch_RotorFromMatrix4(Matrix4 const* m, RotorSoA const& out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        DISPATCH(RotorFromMatrix4, begin, end, m, out);
+    });
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+
+// Bulk versions of the core rotor operations over SoA arrays.
+//
+// Each call runs the scalar, SSE4, AVX2 or AVX-512 variant picked by
+// cpu_dispatch.h, and splits the work over `thread_count` threads
+// (0 = one per hardware thread). Results match the single-element functions
+// to within rounding. Outputs may alias the matching inputs.
+
+
+// out[i] = Vec_Rotate(R[i], v[i])
+void
+Batch_Rotate(RotorSoA const& R, VecSoA const& v, VecSoA const& out, size_t count, int thread_count = 0);
+
+
+// out[i] = Geo_Mul(X[i], Y[i])
+void
+Batch_GeoMul(RotorSoA const& X, RotorSoA const& Y, RotorSoA const& out, size_t count, int thread_count = 0);
+
+
+// out[i] = ToMatrix4(R[i])
+void
+Batch_ToMatrix4(RotorSoA const& R, Matrix4* out, size_t count, int thread_count = 0);
+
+
+// Geo_Normalise(R[i]), in place.
+void
+Batch_Normalise(RotorSoA const& R, size_t count, int thread_count = 0);
+
+
+// out[i] = RotorFromMatrix4(m[i])
+void
+Batch_RotorFromMatrix4(Matrix4 const* m, RotorSoA const& out, size_t count, int thread_count = 0);
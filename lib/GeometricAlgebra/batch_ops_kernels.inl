@@ -0,0 +1,232 @@
+// Kernel bodies shared by every instruction set in batch_ops.cpp.
+//
+// Included once per path with these defined:
+//   V            the vector type (float for the scalar path)
+//   V_WIDTH      lanes per V
+//   V_LOAD(p)    V_STORE(p, v)    V_SET1(x)
+//   V_ADD(a, b)  V_SUB(a, b)      V_MUL(a, b)   V_DIV(a, b)   V_SQRT(a)
+//   V_LT(a, b)   a lane mask      V_SELECT(m, a, b), a where m is set, else b
+//   KERNEL(name) the name of the kernel for this path
+//
+// Each kernel processes whole vectors from `begin` and returns the index of
+// the first element it did not process; the caller finishes the tail with
+// the scalar path.
+
+
+static inline void
+KERNEL(RotateOne)(V s, V b12, V b13, V b23, V vx, V vy, V vz, V& ox, V& oy, V& oz)
+{
+    // Vec_Mul(R, v)
+    auto wx = V_ADD(V_ADD(V_MUL(vx, s), V_MUL(vy, b12)), V_MUL(vz, b13));
+    auto wy = V_ADD(V_ADD(V_MUL(V_SUB(V_SET1(0.0f), vx), b12), V_MUL(vy, s)), V_MUL(vz, b23));
+    auto wz = V_ADD(V_SUB(V_MUL(V_SUB(V_SET1(0.0f), vx), b13), V_MUL(vy, b23)), V_MUL(vz, s));
+    auto T  = V_ADD(V_SUB(V_MUL(vx, b23), V_MUL(vy, b13)), V_MUL(vz, b12));
+
+    // Then by the reverse of R, as in Vec_Rotate.
+    ox = V_ADD(V_ADD(V_ADD(V_MUL(s, wx), V_MUL(wy, b12)), V_MUL(wz, b13)), V_MUL(b23, T));
+    oy = V_SUB(V_ADD(V_SUB(V_MUL(s, wy), V_MUL(wx, b12)), V_MUL(wz, b23)), V_MUL(b13, T));
+    oz = V_ADD(V_SUB(V_SUB(V_MUL(s, wz), V_MUL(wx, b13)), V_MUL(wy, b23)), V_MUL(b12, T));
+}
+
+
+static size_t
+KERNEL(Rotate)(RotorSoA const& R, VecSoA const& v, VecSoA const& out, size_t begin, size_t end)
+{
+    size_t i = begin;
+    for (; i + V_WIDTH <= end; i += V_WIDTH)
+    {
+        V ox, oy, oz;
+        KERNEL(RotateOne)(V_LOAD(R.s + i), V_LOAD(R.e12 + i), V_LOAD(R.e13 + i), V_LOAD(R.e23 + i),
+                          V_LOAD(v.x + i), V_LOAD(v.y + i), V_LOAD(v.z + i),
+                          ox, oy, oz);
+        V_STORE(out.x + i, ox);
+        V_STORE(out.y + i, oy);
+        V_STORE(out.z + i, oz);
+    }
+    return i;
+}
+
+
+static inline void
+KERNEL(NormaliseOne)(V& s, V& e12, V& e13, V& e23)
+{
+    auto l2 = V_ADD(V_ADD(V_ADD(V_MUL(s, s), V_MUL(e12, e12)), V_MUL(e13, e13)), V_MUL(e23, e23));
+    auto l  = V_SQRT(l2);
+    s       = V_DIV(s, l);
+    e12     = V_DIV(e12, l);
+    e13     = V_DIV(e13, l);
+    e23     = V_DIV(e23, l);
+}
+
+
+static size_t
+KERNEL(GeoMul)(RotorSoA const& X, RotorSoA const& Y, RotorSoA const& out, size_t begin, size_t end)
+{
+    size_t i = begin;
+    for (; i + V_WIDTH <= end; i += V_WIDTH)
+    {
+        auto p_a   = V_LOAD(X.s + i);
+        auto p_b01 = V_LOAD(X.e12 + i);
+        auto p_b02 = V_LOAD(X.e13 + i);
+        auto p_b12 = V_LOAD(X.e23 + i);
+
+        auto q_a   = V_LOAD(Y.s + i);
+        auto q_b01 = V_LOAD(Y.e12 + i);
+        auto q_b02 = V_LOAD(Y.e13 + i);
+        auto q_b12 = V_LOAD(Y.e23 + i);
+
+        // Same terms, in the same order, as Geo_Mul.
+        auto s = V_SUB(V_SUB(V_SUB(V_MUL(p_a, q_a), V_MUL(p_b01, q_b01)), V_MUL(p_b02, q_b02)), V_MUL(p_b12, q_b12));
+        auto e12 = V_SUB(V_ADD(V_ADD(V_MUL(p_a, q_b01), V_MUL(q_a, p_b01)), V_MUL(p_b02, q_b12)), V_MUL(p_b12, q_b02));
+        auto e13 = V_SUB(V_ADD(V_ADD(V_MUL(p_a, q_b02), V_MUL(p_b01, q_b12)), V_MUL(q_a, p_b02)), V_MUL(p_b12, q_b01));
+        auto e23 = V_ADD(V_ADD(V_SUB(V_MUL(p_a, q_b12), V_MUL(p_b01, q_b02)), V_MUL(p_b02, q_b01)), V_MUL(q_a, p_b12));
+
+        KERNEL(NormaliseOne)(s, e12, e13, e23);
+
+        V_STORE(out.s + i, s);
+        V_STORE(out.e12 + i, e12);
+        V_STORE(out.e13 + i, e13);
+        V_STORE(out.e23 + i, e23);
+    }
+    return i;
+}
+
+
+static size_t
+KERNEL(Normalise)(RotorSoA const& R, size_t begin, size_t end)
+{
+    size_t i = begin;
+    for (; i + V_WIDTH <= end; i += V_WIDTH)
+    {
+        auto s   = V_LOAD(R.s + i);
+        auto e12 = V_LOAD(R.e12 + i);
+        auto e13 = V_LOAD(R.e13 + i);
+        auto e23 = V_LOAD(R.e23 + i);
+
+        KERNEL(NormaliseOne)(s, e12, e13, e23);
+
+        V_STORE(R.s + i, s);
+        V_STORE(R.e12 + i, e12);
+        V_STORE(R.e13 + i, e13);
+        V_STORE(R.e23 + i, e23);
+    }
+    return i;
+}
+
+
+static size_t
+KERNEL(ToMatrix4)(RotorSoA const& R, Matrix4* out, size_t begin, size_t end)
+{
+    auto const zero = V_SET1(0.0f);
+    auto const one  = V_SET1(1.0f);
+
+    // Rows are computed across lanes, then scattered into the matrices.
+    float rows[9][V_WIDTH];
+
+    size_t i = begin;
+    for (; i + V_WIDTH <= end; i += V_WIDTH)
+    {
+        auto s   = V_LOAD(R.s + i);
+        auto b12 = V_LOAD(R.e12 + i);
+        auto b13 = V_LOAD(R.e13 + i);
+        auto b23 = V_LOAD(R.e23 + i);
+
+        V x, y, z;
+        KERNEL(RotateOne)(s, b12, b13, b23, one, zero, zero, x, y, z);
+        V_STORE(rows[0], x);
+        V_STORE(rows[1], y);
+        V_STORE(rows[2], z);
+        KERNEL(RotateOne)(s, b12, b13, b23, zero, one, zero, x, y, z);
+        V_STORE(rows[3], x);
+        V_STORE(rows[4], y);
+        V_STORE(rows[5], z);
+        KERNEL(RotateOne)(s, b12, b13, b23, zero, zero, one, x, y, z);
+        V_STORE(rows[6], x);
+        V_STORE(rows[7], y);
+        V_STORE(rows[8], z);
+
+        for (int k = 0; k < V_WIDTH; ++k)
+        {
+            auto& m = out[i + k];
+            m[0]    = rows[0][k];
+            m[1]    = rows[1][k];
+            m[2]    = rows[2][k];
+            m[3]    = 0;
+            m[4]    = rows[3][k];
+            m[5]    = rows[4][k];
+            m[6]    = rows[5][k];
+            m[7]    = 0;
+            m[8]    = rows[6][k];
+            m[9]    = rows[7][k];
+            m[10]   = rows[8][k];
+            m[11]   = 0;
+            m[12]   = 0;
+            m[13]   = 0;
+            m[14]   = 0;
+            m[15]   = 1;
+        }
+    }
+    return i;
+}
+
+
+static size_t
+KERNEL(RotorFromMatrix4)(Matrix4 const* m, RotorSoA const& out, size_t begin, size_t end)
+{
+    auto const zero = V_SET1(0.0f);
+    auto const one  = V_SET1(1.0f);
+    auto const half = V_SET1(0.5f);
+
+    // The nine rotation entries are gathered across lanes, then run through
+    // the same selects as RotorFromMatrix4.
+    int const entries[9] = { 0, 5, 10, 4, 1, 8, 2, 9, 6 };
+    float     cols[9][V_WIDTH];
+
+    size_t i = begin;
+    for (; i + V_WIDTH <= end; i += V_WIDTH)
+    {
+        for (int k = 0; k < V_WIDTH; ++k)
+        {
+            for (int e = 0; e < 9; ++e)
+            {
+                cols[e][k] = m[i + k][entries[e]];
+            }
+        }
+
+        auto q00 = V_LOAD(cols[0]), q11 = V_LOAD(cols[1]), q22 = V_LOAD(cols[2]);
+        auto q01 = V_LOAD(cols[3]), q10 = V_LOAD(cols[4]);
+        auto q02 = V_LOAD(cols[5]), q20 = V_LOAD(cols[6]);
+        auto q12 = V_LOAD(cols[7]), q21 = V_LOAD(cols[8]);
+
+        auto c22 = V_LT(q22, zero);
+        auto c01 = V_LT(q11, q00);
+        auto cz  = V_LT(q00, V_SUB(zero, q11));
+
+        auto tx = V_SUB(V_SUB(V_ADD(one, q00), q11), q22);
+        auto ty = V_SUB(V_ADD(V_SUB(one, q00), q11), q22);
+        auto tz = V_ADD(V_SUB(V_SUB(one, q00), q11), q22);
+        auto tw = V_ADD(V_ADD(V_ADD(one, q00), q11), q22);
+
+        auto d21 = V_SUB(q21, q12);
+        auto d02 = V_SUB(q02, q20);
+        auto d10 = V_SUB(q10, q01);
+        auto s01 = V_ADD(q01, q10);
+        auto s02 = V_ADD(q02, q20);
+        auto s12 = V_ADD(q12, q21);
+
+        auto t = V_SELECT(c22, V_SELECT(c01, tx, ty), V_SELECT(cz, tz, tw));
+        auto w = V_SELECT(c22, V_SELECT(c01, d21, d02), V_SELECT(cz, d10, t));
+        auto x = V_SELECT(c22, V_SELECT(c01, t, s01), V_SELECT(cz, s02, d21));
+        auto y = V_SELECT(c22, V_SELECT(c01, s01, t), V_SELECT(cz, s12, d02));
+        auto z = V_SELECT(c22, V_SELECT(c01, s02, s12), V_SELECT(cz, t, d10));
+
+        auto k = V_DIV(half, V_SQRT(t));
+        k      = V_SELECT(V_LT(w, zero), V_SUB(zero, k), k);
+
+        V_STORE(out.s + i, V_MUL(w, k));
+        V_STORE(out.e12 + i, V_SUB(zero, V_MUL(z, k)));
+        V_STORE(out.e13 + i, V_MUL(y, k));
+        V_STORE(out.e23 + i, V_SUB(zero, V_MUL(x, k)));
+    }
+    return i;
+}
@@ -0,0 +1,484 @@
+#include "GeometricAlgebra/clifford.h"
+#include <cassert>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Sign from reordering blade(a) * blade(b) into canonical (ascending) order.
+// Counts, for each basis vector of b, the basis vectors of a that must swap
+// past it.
+static int
+ReorderSign(Blade a, Blade b)
+{
+    a >>= 1;
+    int swaps = 0;
+    while (a != 0)
+    {
+        swaps += __builtin_popcount(a & b);
+        a >>= 1;
+    }
+    return (swaps & 1) ? -1 : 1;
+}
+
+
+static Cl_Algebra*
+BuildAlgebra(int p, int q, int r)
+{
+    auto A         = (Cl_Algebra*)malloc(sizeof(Cl_Algebra));
+    A->p           = p;
+    A->q           = q;
+    A->r           = r;
+    A->dimension   = p + q + r;
+    A->blade_count = 1u << A->dimension;
+
+    auto N   = A->blade_count;
+    A->sign  = (int8_t*)malloc(N * N);
+    A->grade = (uint8_t*)malloc(N);
+
+    Blade negative = ((1u << q) - 1) << p;
+    Blade null     = ((1u << r) - 1) << (p + q);
+
+    for (Blade a = 0; a < N; ++a)
+    {
+        A->grade[a] = (uint8_t)__builtin_popcount(a);
+
+        for (Blade b = 0; b < N; ++b)
+        {
+            auto common = a & b;
+            int  s      = ReorderSign(a, b);
+            if (common & null)
+            {
+                s = 0;
+            }
+            else if (__builtin_popcount(common & negative) & 1)
+            {
+                s = -s;
+            }
+            A->sign[a * N + b] = (int8_t)s;
+        }
+    }
+    return A;
+}
+
+
+struct AlgebraCacheEntry
+{
+    Cl_Algebra*        algebra;
+    AlgebraCacheEntry* next;
+};
+
+
+Cl_Algebra const*
+Cl_GetAlgebra(int p, int q, int r)
+{
+    static std::mutex         lock;
+    static AlgebraCacheEntry* cache = nullptr;
+
+    if (p < 0 || q < 0 || r < 0 || p + q + r > CL_MAX_DIMENSION)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (auto entry = cache; entry; entry = entry->next)
+    {
+        auto A = entry->algebra;
+        if (A->p == p && A->q == q && A->r == r)
+        {
+            return A;
+        }
+    }
+
+    auto entry     = (AlgebraCacheEntry*)malloc(sizeof(AlgebraCacheEntry));
+    entry->algebra = BuildAlgebra(p, q, r);
+    entry->next    = cache;
+    cache          = entry;
+    return entry->algebra;
+}
+
+
+Cl_Arena
+Cl_ArenaCreate(size_t bytes)
+{
+    Cl_Arena arena;
+    arena.base = (unsigned char*)malloc(bytes);
+    arena.size = arena.base ? bytes : 0;
+    arena.used = 0;
+    return arena;
+}
+
+
+void
+Cl_ArenaDestroy(Cl_Arena& arena)
+{
+    free(arena.base);
+    arena.base = nullptr;
+    arena.size = 0;
+    arena.used = 0;
+}
+
+
+void*
+Cl_ArenaAlloc(Cl_Arena& arena, size_t bytes, size_t align)
+{
+    auto start = (arena.used + align - 1) & ~(align - 1);
+    if (start + bytes > arena.size)
+    {
+        // Callers write through the result unconditionally, so running out
+        // is fatal in every build rather than a null dereference later.
+        fprintf(stderr, "Cl_Arena exhausted: %zu bytes requested, %zu of %zu used\n", bytes, arena.used, arena.size);
+        abort();
+    }
+    arena.used = start + bytes;
+    return arena.base + start;
+}
+
+
+static Cl_Multivector
+Allocate(Cl_Algebra const* A, Cl_Arena& arena, uint32_t capacity)
+{
+    Cl_Multivector M;
+    M.algebra = A;
+    M.blades  = (Blade*)Cl_ArenaAlloc(arena, capacity * sizeof(Blade), alignof(Blade));
+    M.coeffs  = (float*)Cl_ArenaAlloc(arena, capacity * sizeof(float), alignof(float));
+    M.count   = 0;
+    return M;
+}
+
+
+Cl_Multivector
+Cl_Zero(Cl_Algebra const* A)
+{
+    return { A, nullptr, nullptr, 0 };
+}
+
+
+Cl_Multivector
+Cl_FromBlade(Cl_Algebra const* A, Cl_Arena& arena, Blade b, float value)
+{
+    assert(b < A->blade_count);
+
+    if (value == 0.0f)
+    {
+        return Cl_Zero(A);
+    }
+
+    auto M      = Allocate(A, arena, 1);
+    M.blades[0] = b;
+    M.coeffs[0] = value;
+    M.count     = 1;
+    return M;
+}
+
+
+Cl_Multivector
+Cl_Scalar(Cl_Algebra const* A, Cl_Arena& arena, float s)
+{
+    return Cl_FromBlade(A, arena, 0, s);
+}
+
+
+Cl_Multivector
+Cl_FromVector(Cl_Algebra const* A, Cl_Arena& arena, float const* components)
+{
+    auto M = Allocate(A, arena, A->dimension);
+    for (int i = 0; i < A->dimension; ++i)
+    {
+        if (components[i] != 0.0f)
+        {
+            M.blades[M.count] = 1u << i;
+            M.coeffs[M.count] = components[i];
+            M.count++;
+        }
+    }
+    return M;
+}
+
+
+float
+Cl_Get(Cl_Multivector const& M, Blade b)
+{
+    for (uint32_t i = 0; i < M.count; ++i)
+    {
+        if (M.blades[i] == b)
+        {
+            return M.coeffs[i];
+        }
+    }
+    return 0.0f;
+}
+
+
+Cl_Multivector
+Cl_Add(Cl_Arena& arena, Cl_Multivector const& X, Cl_Multivector const& Y)
+{
+    auto M = Allocate(X.algebra, arena, X.count + Y.count);
+
+    // Both inputs are sorted, so merge them.
+    uint32_t i = 0;
+    uint32_t k = 0;
+    while (i < X.count || k < Y.count)
+    {
+        Blade b;
+        float c;
+        if (k == Y.count || (i < X.count && X.blades[i] < Y.blades[k]))
+        {
+            b = X.blades[i];
+            c = X.coeffs[i++];
+        }
+        else if (i == X.count || Y.blades[k] < X.blades[i])
+        {
+            b = Y.blades[k];
+            c = Y.coeffs[k++];
+        }
+        else
+        {
+            b = X.blades[i];
+            c = X.coeffs[i++] + Y.coeffs[k++];
+        }
+
+        if (c != 0.0f)
+        {
+            M.blades[M.count] = b;
+            M.coeffs[M.count] = c;
+            M.count++;
+        }
+    }
+    return M;
+}
+
+
+Cl_Multivector
+Cl_Scale(Cl_Arena& arena, Cl_Multivector const& X, float s)
+{
+    if (s == 0.0f)
+    {
+        return Cl_Zero(X.algebra);
+    }
+
+    auto M = Allocate(X.algebra, arena, X.count);
+    for (uint32_t i = 0; i < X.count; ++i)
+    {
+        M.blades[i] = X.blades[i];
+        M.coeffs[i] = X.coeffs[i] * s;
+    }
+    M.count = X.count;
+    return M;
+}
+
+
+// Shared by the geometric and outer products. Terms are accumulated into a
+// dense scratch buffer indexed by blade, then compacted into the result.
+// The scratch buffer is released back to the arena before returning.
+static Cl_Multivector
+Product(Cl_Arena& arena, Cl_Multivector const& X, Cl_Multivector const& Y, bool wedge)
+{
+    auto A = X.algebra;
+    assert(A == Y.algebra);
+
+    uint64_t capacity = (uint64_t)X.count * Y.count;
+    if (capacity > A->blade_count)
+    {
+        capacity = A->blade_count;
+    }
+
+    auto M    = Allocate(A, arena, (uint32_t)capacity);
+    auto mark = Cl_ArenaMark(arena);
+
+    auto dense = (float*)Cl_ArenaAlloc(arena, A->blade_count * sizeof(float));
+    auto used  = (uint8_t*)Cl_ArenaAlloc(arena, A->blade_count, 1);
+    memset(used, 0, A->blade_count);
+
+    for (uint32_t i = 0; i < X.count; ++i)
+    {
+        auto a    = X.blades[i];
+        auto row  = A->sign + a * A->blade_count;
+        auto x    = X.coeffs[i];
+
+        for (uint32_t k = 0; k < Y.count; ++k)
+        {
+            auto b = Y.blades[k];
+            if (wedge && (a & b))
+            {
+                continue;
+            }
+
+            auto s = row[b];
+            if (s == 0)
+            {
+                continue;
+            }
+
+            auto blade = a ^ b;
+            if (!used[blade])
+            {
+                used[blade]  = 1;
+                dense[blade] = 0.0f;
+            }
+            dense[blade] += s * x * Y.coeffs[k];
+        }
+    }
+
+    for (Blade b = 0; b < A->blade_count; ++b)
+    {
+        if (used[b] && dense[b] != 0.0f)
+        {
+            M.blades[M.count] = b;
+            M.coeffs[M.count] = dense[b];
+            M.count++;
+        }
+    }
+
+    Cl_ArenaRewind(arena, mark);
+    return M;
+}
+
+
+Cl_Multivector
+Cl_Mul(Cl_Arena& arena, Cl_Multivector const& X, Cl_Multivector const& Y)
+{
+    return Product(arena, X, Y, false);
+}
+
+
+Cl_Multivector
+Cl_Wedge(Cl_Arena& arena, Cl_Multivector const& X, Cl_Multivector const& Y)
+{
+    return Product(arena, X, Y, true);
+}
+
+
+Cl_Multivector
+Cl_Reverse(Cl_Arena& arena, Cl_Multivector const& X)
+{
+    auto M = Allocate(X.algebra, arena, X.count);
+    for (uint32_t i = 0; i < X.count; ++i)
+    {
+        auto k      = X.algebra->grade[X.blades[i]];
+        M.blades[i] = X.blades[i];
+        M.coeffs[i] = (k & 2) ? -X.coeffs[i] : X.coeffs[i];
+    }
+    M.count = X.count;
+    return M;
+}
+
+
+Cl_Multivector
+Cl_Grade(Cl_Arena& arena, Cl_Multivector const& X, int k)
+{
+    auto M = Allocate(X.algebra, arena, X.count);
+    for (uint32_t i = 0; i < X.count; ++i)
+    {
+        if (X.algebra->grade[X.blades[i]] == k)
+        {
+            M.blades[M.count] = X.blades[i];
+            M.coeffs[M.count] = X.coeffs[i];
+            M.count++;
+        }
+    }
+    return M;
+}
+
+
+Cl_Multivector
+Cl_Sandwich(Cl_Arena& arena, Cl_Multivector const& R, Cl_Multivector const& X)
+{
+    // Only the result is kept; the intermediates are released.
+    auto mark = Cl_ArenaMark(arena);
+    auto RX   = Cl_Mul(arena, R, X);
+    auto Rrev = Cl_Reverse(arena, R);
+
+    // Compute into a temporary, then copy down over the intermediates.
+    auto tmp  = Cl_Mul(arena, RX, Rrev);
+    auto size = tmp.count;
+    Cl_ArenaRewind(arena, mark);
+
+    auto M = Allocate(R.algebra, arena, size);
+    memmove(M.blades, tmp.blades, size * sizeof(Blade));
+    memmove(M.coeffs, tmp.coeffs, size * sizeof(float));
+    M.count = size;
+    return M;
+}
+
+
+Cl_Multivector
+Cl_FromVec(Cl_Algebra const* A, Cl_Arena& arena, Vec const& v)
+{
+    assert(A->dimension == 3);
+    return Cl_FromVector(A, arena, v.data);
+}
+
+
+Cl_Multivector
+Cl_FromRotor(Cl_Algebra const* A, Cl_Arena& arena, Rotor const& R)
+{
+    assert(A->dimension == 3);
+
+    Blade const blades[4] = { 0b000, 0b011, 0b101, 0b110 };
+    float const coeffs[4] = { R.s, R.B.e12, R.B.e13, R.B.e23 };
+
+    auto M = Allocate(A, arena, 4);
+    for (int i = 0; i < 4; ++i)
+    {
+        if (coeffs[i] != 0.0f)
+        {
+            M.blades[M.count] = blades[i];
+            M.coeffs[M.count] = coeffs[i];
+            M.count++;
+        }
+    }
+    return M;
+}
+
+
+Vec
+Cl_ToVec(Cl_Multivector const& M)
+{
+    return {
+        Cl_Get(M, 0b001),
+        Cl_Get(M, 0b010),
+        Cl_Get(M, 0b100)
+    };
+}
+
+
+Rotor
+Cl_ToRotor(Cl_Multivector const& M)
+{
+    return Rotor(Cl_Get(M, 0b000), Cl_Get(M, 0b011), Cl_Get(M, 0b101), Cl_Get(M, 0b110));
+}
+
+
+void
+Print(char const* text, Cl_Multivector const& M)
+{
+    printf("%s", text);
+    if (M.count == 0)
+    {
+        printf(" 0");
+    }
+    for (uint32_t i = 0; i < M.count; ++i)
+    {
+        printf(" %0.3f<", M.coeffs[i]);
+        if (M.blades[i] == 0)
+        {
+            printf("s");
+        }
+        else
+        {
+            printf("e");
+            for (int k = 0; k < M.algebra->dimension; ++k)
+            {
+                if (M.blades[i] & (1u << k))
+                {
+                    printf("%d", k + 1);
+                }
+            }
+        }
+        printf(">");
+    }
+    printf("\n");
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+
+// General Clifford algebra Cl(p,q,r) with the dimension chosen at runtime.
+//
+// Basis blades are indexed by bitmap: bit i is set when basis vector e(i+1)
+// is a factor of the blade, e.g. e13 -> 0b101. The first p basis vectors
+// square to +1, the next q to -1 and the last r to 0.
+//
+// For Cl(3,0) the blades line up with the fixed-size types:
+//   Vec      { x, y, z }        -> e1, e2, e3
+//   BiVector { e12, e13, e23 }  -> 0b011, 0b101, 0b110
+//   TriVector{ e123 }           -> 0b111
+
+
+typedef uint32_t Blade;
+
+#define CL_MAX_DIMENSION 10
+
+
+struct Cl_Algebra
+{
+    int p, q, r;
+    int dimension;
+
+    // 1 << dimension.
+    uint32_t blade_count;
+
+    // blade_count * blade_count entries. sign[a * blade_count + b] is the
+    // scalar factor (+1, -1 or 0) of blade(a) * blade(b), which is always
+    // blade(a ^ b). It combines the reordering sign with the metric.
+    int8_t* sign;
+
+    // Grade (number of set bits) of every blade.
+    uint8_t* grade;
+};
+
+
+// Returns the algebra for the signature, building its product tables on
+// first use. Tables are cached for the life of the process, so the returned
+// pointer may be kept. Returns nullptr if p + q + r > CL_MAX_DIMENSION.
+// Safe to call from multiple threads.
+Cl_Algebra const*
+Cl_GetAlgebra(int p, int q, int r = 0);
+
+
+inline int
+Cl_Sign(Cl_Algebra const* A, Blade a, Blade b)
+{
+    return A->sign[a * A->blade_count + b];
+}
+
+
+// Linear bump allocator. Multivector temporaries are carved from it so
+// expression evaluation never touches the heap. Reset or rewind to reuse.
+//
+// Running out of space aborts the process, in all builds, so size arenas for
+// the worst case. With N = A->blade_count = 2^dimension, a multivector with
+// room for n blades takes 8n bytes (plus up to 4 bytes of alignment), and:
+//
+//   Cl_Add             8 (|X| + |Y|)
+//   Cl_Scale, Cl_Reverse, Cl_Grade   8 |X|
+//   Cl_Mul, Cl_Wedge   8 min(|X| |Y|, N) kept, plus 5N scratch released
+//                      before returning
+//   Cl_Sandwich        R X, ~R and the final product (each at most 8N)
+//                      plus 5N scratch, so up to 29N at peak; only the
+//                      result, at most 8N, is kept
+//
+// So 32N bytes free covers any single operation; for Cl(10) that is 32 KiB.
+struct Cl_Arena
+{
+    unsigned char* base;
+    size_t         size;
+    size_t         used;
+};
+
+
+Cl_Arena
+Cl_ArenaCreate(size_t bytes);
+
+
+void
+Cl_ArenaDestroy(Cl_Arena& arena);
+
+
+// Aborts with a message if the arena is exhausted; never returns nullptr.
+void*
+Cl_ArenaAlloc(Cl_Arena& arena, size_t bytes, size_t align = alignof(float));
+
+
+inline size_t
+Cl_ArenaMark(Cl_Arena const& arena)
+{
+    return arena.used;
+}
+
+
+inline void
+Cl_ArenaRewind(Cl_Arena& arena, size_t mark)
+{
+    arena.used = mark;
+}
+
+
+inline void
+Cl_ArenaReset(Cl_Arena& arena)
+{
+    arena.used = 0;
+}
+
+
+// Sparse multivector. Only non-zero blades are stored, sorted by bitmap.
+// The arrays live in whichever arena created the multivector.
+struct Cl_Multivector
+{
+    Cl_Algebra const* algebra;
+    Blade*            blades;
+    float*            coeffs;
+    uint32_t          count;
+};
+
+
+Cl_Multivector
+Cl_Zero(Cl_Algebra const* A);
+
+
+Cl_Multivector
+Cl_Scalar(Cl_Algebra const* A, Cl_Arena& arena, float s);
+
+
+Cl_Multivector
+Cl_FromBlade(Cl_Algebra const* A, Cl_Arena& arena, Blade b, float value);
+
+
+// Creates a grade 1 multivector from A->dimension components.
+Cl_Multivector
+Cl_FromVector(Cl_Algebra const* A, Cl_Arena& arena, float const* components);
+
+
+// Returns the coefficient of blade b, or 0 if it is not stored.
+float
+Cl_Get(Cl_Multivector const& M, Blade b);
+
+
+Cl_Multivector
+Cl_Add(Cl_Arena& arena, Cl_Multivector const& X, Cl_Multivector const& Y);
+
+
+Cl_Multivector
+Cl_Scale(Cl_Arena& arena, Cl_Multivector const& X, float s);
+
+
+// Geometric product XY.
+Cl_Multivector
+Cl_Mul(Cl_Arena& arena, Cl_Multivector const& X, Cl_Multivector const& Y);
+
+
+// Outer (wedge) product X^Y.
+Cl_Multivector
+Cl_Wedge(Cl_Arena& arena, Cl_Multivector const& X, Cl_Multivector const& Y);
+
+
+// Reverse ~X. Flips the sign of grades 2 and 3 (mod 4).
+Cl_Multivector
+Cl_Reverse(Cl_Arena& arena, Cl_Multivector const& X);
+
+
+// Extracts the grade k part of X.
+Cl_Multivector
+Cl_Grade(Cl_Arena& arena, Cl_Multivector const& X, int k);
+
+
+// R X ~R.
+Cl_Multivector
+Cl_Sandwich(Cl_Arena& arena, Cl_Multivector const& R, Cl_Multivector const& X);
+
+
+// Conversions between Cl(3,0) and the fixed-size types.
+Cl_Multivector
+Cl_FromVec(Cl_Algebra const* A, Cl_Arena& arena, Vec const& v);
+
+
+Cl_Multivector
+Cl_FromRotor(Cl_Algebra const* A, Cl_Arena& arena, Rotor const& R);
+
+
+Vec
+Cl_ToVec(Cl_Multivector const& M);
+
+
+Rotor
+Cl_ToRotor(Cl_Multivector const& M);
+
+
+void
+Print(char const* text, Cl_Multivector const& M);
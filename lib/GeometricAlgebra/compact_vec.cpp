@@ -0,0 +1,488 @@
+#include "GeometricAlgebra/compact_vec.h"
+#include "GeometricAlgebra/cpu_dispatch.h"
+#include "GeometricAlgebra/rotation3.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GA_X86 1
+#include <immintrin.h>
+#endif
+
+
+// ---- Half, software ----
+
+static size_t
+EncodeScalar(VecSoA const& in, VecHalfSoA const& out, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        out.x[i] = Half_FromFloat(in.x[i]);
+        out.y[i] = Half_FromFloat(in.y[i]);
+        out.z[i] = Half_FromFloat(in.z[i]);
+    }
+    return end;
+}
+
+
+static size_t
+DecodeScalar(VecHalfSoA const& in, VecSoA const& out, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        out.x[i] = Half_ToFloat(in.x[i]);
+        out.y[i] = Half_ToFloat(in.y[i]);
+        out.z[i] = Half_ToFloat(in.z[i]);
+    }
+    return end;
+}
+
+
+static size_t
+RotateScalar(Rotation3 const& Q, VecHalfSoA const& in, VecHalfSoA const& out, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto x   = Half_ToFloat(in.x[i]);
+        auto y   = Half_ToFloat(in.y[i]);
+        auto z   = Half_ToFloat(in.z[i]);
+        out.x[i] = Half_FromFloat(Q.m[0][0] * x + Q.m[0][1] * y + Q.m[0][2] * z);
+        out.y[i] = Half_FromFloat(Q.m[1][0] * x + Q.m[1][1] * y + Q.m[1][2] * z);
+        out.z[i] = Half_FromFloat(Q.m[2][0] * x + Q.m[2][1] * y + Q.m[2][2] * z);
+    }
+    return end;
+}
+
+
+static size_t
+NormaliseScalar(VecHalfSoA const& in, VecHalfSoA const& out, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto x   = Half_ToFloat(in.x[i]);
+        auto y   = Half_ToFloat(in.y[i]);
+        auto z   = Half_ToFloat(in.z[i]);
+        auto l2  = x * x + y * y + z * z;
+        auto inv = l2 > 0.0f ? 1.0f / sqrtf(l2) : 0.0f;
+        out.x[i] = Half_FromFloat(x * inv);
+        out.y[i] = Half_FromFloat(y * inv);
+        out.z[i] = Half_FromFloat(z * inv);
+    }
+    return end;
+}
+
+
+static size_t
+DistanceScalar(VecHalfSoA const& in, Vec const& p, float* distance, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        distance[i] = Vec_Distance({ Half_ToFloat(in.x[i]), Half_ToFloat(in.y[i]), Half_ToFloat(in.z[i]) }, p);
+    }
+    return end;
+}
+
+
+// ---- Half, F16C ----
+
+#if defined(GA_X86)
+
+GA_TARGET_BEGIN("avx2,f16c")
+
+static inline __m256
+LoadHalf8(uint16_t const* p)
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128((__m128i const*)p));
+}
+
+
+static inline void
+StoreHalf8(uint16_t* p, __m256 v)
+{
+    _mm_storeu_si128((__m128i*)p, _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+
+static size_t
+EncodeF16C(VecSoA const& in, VecHalfSoA const& out, size_t begin, size_t end)
+{
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        StoreHalf8(out.x + i, _mm256_loadu_ps(in.x + i));
+        StoreHalf8(out.y + i, _mm256_loadu_ps(in.y + i));
+        StoreHalf8(out.z + i, _mm256_loadu_ps(in.z + i));
+    }
+    return i;
+}
+
+
+static size_t
+DecodeF16C(VecHalfSoA const& in, VecSoA const& out, size_t begin, size_t end)
+{
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        _mm256_storeu_ps(out.x + i, LoadHalf8(in.x + i));
+        _mm256_storeu_ps(out.y + i, LoadHalf8(in.y + i));
+        _mm256_storeu_ps(out.z + i, LoadHalf8(in.z + i));
+    }
+    return i;
+}
+
+
+static size_t
+RotateF16C(Rotation3 const& Q, VecHalfSoA const& in, VecHalfSoA const& out, size_t begin, size_t end)
+{
+    __m256 m[3][3];
+    for (int k = 0; k < 3; ++k)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            m[k][j] = _mm256_set1_ps(Q.m[k][j]);
+        }
+    }
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        auto x = LoadHalf8(in.x + i);
+        auto y = LoadHalf8(in.y + i);
+        auto z = LoadHalf8(in.z + i);
+
+        // Same evaluation order as RotateScalar.
+        auto rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[0][0], x), _mm256_mul_ps(m[0][1], y)), _mm256_mul_ps(m[0][2], z));
+        auto ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[1][0], x), _mm256_mul_ps(m[1][1], y)), _mm256_mul_ps(m[1][2], z));
+        auto rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[2][0], x), _mm256_mul_ps(m[2][1], y)), _mm256_mul_ps(m[2][2], z));
+
+        StoreHalf8(out.x + i, rx);
+        StoreHalf8(out.y + i, ry);
+        StoreHalf8(out.z + i, rz);
+    }
+    return i;
+}
+
+
+static size_t
+NormaliseF16C(VecHalfSoA const& in, VecHalfSoA const& out, size_t begin, size_t end)
+{
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        auto x = LoadHalf8(in.x + i);
+        auto y = LoadHalf8(in.y + i);
+        auto z = LoadHalf8(in.z + i);
+
+        auto l = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+
+        // Zero vectors stay zero, as in the scalar path.
+        auto nonzero = _mm256_cmp_ps(l, _mm256_setzero_ps(), _CMP_GT_OQ);
+
+        StoreHalf8(out.x + i, _mm256_and_ps(nonzero, _mm256_div_ps(x, l)));
+        StoreHalf8(out.y + i, _mm256_and_ps(nonzero, _mm256_div_ps(y, l)));
+        StoreHalf8(out.z + i, _mm256_and_ps(nonzero, _mm256_div_ps(z, l)));
+    }
+    return i;
+}
+
+
+static size_t
+DistanceF16C(VecHalfSoA const& in, Vec const& p, float* distance, size_t begin, size_t end)
+{
+    auto px = _mm256_set1_ps(p.x);
+    auto py = _mm256_set1_ps(p.y);
+    auto pz = _mm256_set1_ps(p.z);
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        auto dx = _mm256_sub_ps(LoadHalf8(in.x + i), px);
+        auto dy = _mm256_sub_ps(LoadHalf8(in.y + i), py);
+        auto dz = _mm256_sub_ps(LoadHalf8(in.z + i), pz);
+
+        auto d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        _mm256_storeu_ps(distance + i, _mm256_sqrt_ps(d2));
+    }
+    return i;
+}
+
+GA_TARGET_END
+
+#endif
+
+
+static bool
+UseF16C()
+{
+#if defined(GA_X86)
+    static bool const has_f16c = Cpu_HasF16C();
+    return has_f16c && Cpu_ActivePath() >= CpuPath_AVX2;
+#else
+    return false;
+#endif
+}
+
+
+// Runs the F16C kernel if it is usable, then finishes with the scalar one.
+#if defined(GA_X86)
+#define HALF_DISPATCH(name, begin, end, ...)                               \
+    do                                                                     \
+    {                                                                      \
+        size_t i_ = UseF16C() ? name##F16C(__VA_ARGS__, begin, end) : begin; \
+        name##Scalar(__VA_ARGS__, i_, end);                                \
+    } while (0)
+#else
+#define HALF_DISPATCH(name, begin, end, ...) name##Scalar(__VA_ARGS__, begin, end)
+#endif
+
+
+void
+VecHalf_Encode(VecSoA const& in, VecHalfSoA const& out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        HALF_DISPATCH(Encode, begin, end, in, out);
+    });
+}
+
+
+void
+VecHalf_Decode(VecHalfSoA const& in, VecSoA const& out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        HALF_DISPATCH(Decode, begin, end, in, out);
+    });
+}
+
+
+void
+VecHalf_Rotate(Rotor const& R, VecHalfSoA const& in, VecHalfSoA const& out, size_t count, int thread_count)
+{
+    auto Q = Rotation3_FromRotor(R);
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        HALF_DISPATCH(Rotate, begin, end, Q, in, out);
+    });
+}
+
+
+void
+VecHalf_Normalise(VecHalfSoA const& in, VecHalfSoA const& out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        HALF_DISPATCH(Normalise, begin, end, in, out);
+    });
+}
+
+
+void
+VecHalf_Distance(VecHalfSoA const& in, Vec const& point, float* distance, size_t count, int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        HALF_DISPATCH(Distance, begin, end, in, point, distance);
+    });
+}
+
+
+// ---- Q16 ----
+//
+// Block loops run over the whole block with a fixed trip count so the
+// compiler vectorises the int16 <-> float conversions.
+
+// Clamps in float before converting, so out-of-range input never reaches
+// an undefined float-to-int conversion. NaN becomes 0.
+static inline int16_t
+Quantise(float x)
+{
+    x = x == x ? x : 0.0f;
+    x = x < 32767.0f ? x : 32767.0f;
+    x = x > -32767.0f ? x : -32767.0f;
+    return (int16_t)(int)(x + (x >= 0.0f ? 0.5f : -0.5f));
+}
+
+
+static inline float
+Inverse(float s)
+{
+    return s > 0.0f ? 1.0f / s : 0.0f;
+}
+
+
+static void
+EncodeBlock(VecSoA const& in, size_t first, size_t n, VecQ16Block& block)
+{
+    float const* src[3] = { in.x + first, in.y + first, in.z + first };
+    int16_t*     dst[3] = { block.x, block.y, block.z };
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        auto lo = src[axis][0];
+        auto hi = src[axis][0];
+        for (size_t j = 1; j < n; ++j)
+        {
+            lo = fminf(lo, src[axis][j]);
+            hi = fmaxf(hi, src[axis][j]);
+        }
+
+        auto offset        = 0.5f * (lo + hi);
+        auto scale         = 0.5f * (hi - lo) / 32767.0f;
+        auto inv           = Inverse(scale);
+        block.offset[axis] = offset;
+        block.scale[axis]  = scale;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            dst[axis][j] = Quantise((src[axis][j] - offset) * inv);
+        }
+        for (size_t j = n; j < VEC_Q16_BLOCK; ++j)
+        {
+            dst[axis][j] = 0;
+        }
+    }
+}
+
+
+// Rotates the first n points of the block into float scratch, then encodes
+// them again against their own exact bounds, so the block's extent stays
+// that of its points however many times it is rotated.
+static void
+RotateBlock(Rotation3 const& Q, size_t n, VecQ16Block& block)
+{
+    float x[VEC_Q16_BLOCK], y[VEC_Q16_BLOCK], z[VEC_Q16_BLOCK];
+
+    // v = c + s q, so Q v = Q c + (Q diag(s)) q.
+    auto  c = block.offset;
+    auto  Qc = Rotation3_Apply(Q, c);
+    float A[3][3];
+    for (int k = 0; k < 3; ++k)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            A[k][i] = Q.m[k][i] * block.scale[i];
+        }
+    }
+
+    for (int j = 0; j < VEC_Q16_BLOCK; ++j)
+    {
+        float qx = block.x[j];
+        float qy = block.y[j];
+        float qz = block.z[j];
+        x[j]     = Qc.x + A[0][0] * qx + A[0][1] * qy + A[0][2] * qz;
+        y[j]     = Qc.y + A[1][0] * qx + A[1][1] * qy + A[1][2] * qz;
+        z[j]     = Qc.z + A[2][0] * qx + A[2][1] * qy + A[2][2] * qz;
+    }
+
+    EncodeBlock({ x, y, z }, 0, n, block);
+}
+
+
+static void
+NormaliseBlock(VecQ16Block& block)
+{
+    auto c = block.offset;
+    auto s = block.scale;
+
+    for (int j = 0; j < VEC_Q16_BLOCK; ++j)
+    {
+        auto x  = c.x + s.x * block.x[j];
+        auto y  = c.y + s.y * block.y[j];
+        auto z  = c.z + s.z * block.z[j];
+        auto l2 = x * x + y * y + z * z;
+
+        // Zero vectors stay zero. Padding lanes decode to the block centre
+        // and are normalised like any other lane; nothing reads them.
+        auto inv = l2 > 0.0f ? 32767.0f / sqrtf(l2) : 0.0f;
+
+        block.x[j] = Quantise(x * inv);
+        block.y[j] = Quantise(y * inv);
+        block.z[j] = Quantise(z * inv);
+    }
+
+    block.offset = Vec_Zero();
+    block.scale  = { 1.0f / 32767.0f, 1.0f / 32767.0f, 1.0f / 32767.0f };
+}
+
+
+void
+VecQ16_Encode(VecSoA const& in, VecQ16Block* out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(VecQ16_BlockCount(count), 16, thread_count, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            auto first = b * VEC_Q16_BLOCK;
+            auto n     = count - first < VEC_Q16_BLOCK ? count - first : VEC_Q16_BLOCK;
+            EncodeBlock(in, first, n, out[b]);
+        }
+    });
+}
+
+
+void
+VecQ16_Decode(VecQ16Block const* in, VecSoA const& out, size_t count, int thread_count)
+{
+    Batch_ParallelFor(VecQ16_BlockCount(count), 16, thread_count, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            auto const& block = in[b];
+            auto        first = b * VEC_Q16_BLOCK;
+            auto        n     = count - first < VEC_Q16_BLOCK ? count - first : VEC_Q16_BLOCK;
+            for (size_t j = 0; j < n; ++j)
+            {
+                out.x[first + j] = block.offset.x + block.scale.x * block.x[j];
+                out.y[first + j] = block.offset.y + block.scale.y * block.y[j];
+                out.z[first + j] = block.offset.z + block.scale.z * block.z[j];
+            }
+        }
+    });
+}
+
+
+void
+VecQ16_Rotate(Rotor const& R, VecQ16Block* blocks, size_t count, int thread_count)
+{
+    auto Q = Rotation3_FromRotor(R);
+    Batch_ParallelFor(VecQ16_BlockCount(count), 16, thread_count, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            auto first = b * VEC_Q16_BLOCK;
+            auto n     = count - first < VEC_Q16_BLOCK ? count - first : VEC_Q16_BLOCK;
+            RotateBlock(Q, n, blocks[b]);
+        }
+    });
+}
+
+
+void
+VecQ16_Normalise(VecQ16Block* blocks, size_t count, int thread_count)
+{
+    Batch_ParallelFor(VecQ16_BlockCount(count), 16, thread_count, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            NormaliseBlock(blocks[b]);
+        }
+    });
+}
+
+
+void
+VecQ16_Distance(VecQ16Block const* blocks, Vec const& point, float* distance, size_t count, int thread_count)
+{
+    Batch_ParallelFor(VecQ16_BlockCount(count), 16, thread_count, [&](size_t begin, size_t end) {
+        float d[VEC_Q16_BLOCK];
+        for (size_t b = begin; b < end; ++b)
+        {
+            auto const& block = blocks[b];
+            auto        c     = block.offset - point;
+            auto        s     = block.scale;
+
+            for (int j = 0; j < VEC_Q16_BLOCK; ++j)
+            {
+                auto x = c.x + s.x * block.x[j];
+                auto y = c.y + s.y * block.y[j];
+                auto z = c.z + s.z * block.z[j];
+                d[j]   = sqrtf(x * x + y * y + z * z);
+            }
+
+            auto first = b * VEC_Q16_BLOCK;
+            auto n     = count - first < VEC_Q16_BLOCK ? count - first : VEC_Q16_BLOCK;
+            memcpy(distance + first, d, n * sizeof(float));
+        }
+    });
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+
+// Compact storage for large Vec arrays, with batch operations that decode,
+// compute in float and re-encode in registers.
+//
+// Two formats:
+//  - Half: IEEE fp16 per component, SoA. 6 bytes per Vec. Converted with
+//    F16C when the CPU has it and the active dispatch path is AVX2 or
+//    better (see cpu_dispatch.h), and in software otherwise. Both round to
+//    nearest even, so they give identical results.
+//  - Q16: blocks of VEC_Q16_BLOCK Vecs, each stored as int16 normalised to
+//    the block's bounding box: v = offset + scale * q. About 6.4 bytes per
+//    Vec, with precision that follows the block's extent rather than its
+//    distance from the origin.
+//
+// In/out arguments may alias, so every operation can run in place.
+
+
+// ---- Half ----
+
+struct VecHalfSoA
+{
+    uint16_t* x;
+    uint16_t* y;
+    uint16_t* z;
+};
+
+
+// Round to nearest even. Overflow gives infinity; NaN stays NaN.
+inline uint16_t
+Half_FromFloat(float f)
+{
+    uint32_t const f32_infinity = 255u << 23;
+    uint32_t const f16_max      = (127u + 16u) << 23;
+    uint32_t const denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    uint32_t sign = u & 0x80000000u;
+    u ^= sign;
+
+    uint16_t h;
+    if (u >= f16_max)
+    {
+        h = (u > f32_infinity) ? 0x7e00 : 0x7c00;
+    }
+    else if (u < (113u << 23))
+    {
+        // Result is subnormal: let the FPU do the rounding.
+        float magic, v;
+        memcpy(&magic, &denorm_magic, sizeof(magic));
+        memcpy(&v, &u, sizeof(v));
+        v += magic;
+        memcpy(&u, &v, sizeof(u));
+        h = (uint16_t)(u - denorm_magic);
+    }
+    else
+    {
+        uint32_t mantissa_odd = (u >> 13) & 1;
+        u += ((uint32_t)(15 - 127) << 23) + 0xfff;
+        u += mantissa_odd;
+        h = (uint16_t)(u >> 13);
+    }
+    return (uint16_t)(h | (sign >> 16));
+}
+
+
+inline float
+Half_ToFloat(uint16_t h)
+{
+    uint32_t const shifted_exponent = 0x7c00u << 13;
+    uint32_t const magic_bits       = 113u << 23;
+
+    uint32_t u        = (uint32_t)(h & 0x7fff) << 13;
+    uint32_t exponent = shifted_exponent & u;
+    u += (127u - 15u) << 23;
+
+    if (exponent == shifted_exponent)
+    {
+        u += (128u - 16u) << 23; // Inf / NaN
+    }
+    else if (exponent == 0)
+    {
+        // Zero / subnormal: renormalise via the FPU.
+        float magic, v;
+        u += 1u << 23;
+        memcpy(&magic, &magic_bits, sizeof(magic));
+        memcpy(&v, &u, sizeof(v));
+        v -= magic;
+        memcpy(&u, &v, sizeof(u));
+    }
+
+    u |= (uint32_t)(h & 0x8000) << 16;
+
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+
+void
+VecHalf_Encode(VecSoA const& in, VecHalfSoA const& out, size_t count, int thread_count = 0);
+
+
+void
+VecHalf_Decode(VecHalfSoA const& in, VecSoA const& out, size_t count, int thread_count = 0);
+
+
+// out[i] = Vec_Rotate(R, in[i])
+void
+VecHalf_Rotate(Rotor const& R, VecHalfSoA const& in, VecHalfSoA const& out, size_t count, int thread_count = 0);
+
+
+// out[i] = Vec_Normalise(in[i]). Zero vectors stay zero.
+void
+VecHalf_Normalise(VecHalfSoA const& in, VecHalfSoA const& out, size_t count, int thread_count = 0);
+
+
+// distance[i] = Vec_Distance(in[i], point)
+void
+VecHalf_Distance(VecHalfSoA const& in, Vec const& point, float* distance, size_t count, int thread_count = 0);
+
+
+// ---- Q16 ----
+
+#define VEC_Q16_BLOCK 64
+
+
+struct VecQ16Block
+{
+    Vec     offset; // Centre of the block's bounds.
+    Vec     scale;  // Half-extent / 32767, per axis.
+    int16_t x[VEC_Q16_BLOCK];
+    int16_t y[VEC_Q16_BLOCK];
+    int16_t z[VEC_Q16_BLOCK];
+};
+
+
+inline size_t
+VecQ16_BlockCount(size_t count)
+{
+    return (count + VEC_Q16_BLOCK - 1) / VEC_Q16_BLOCK;
+}
+
+
+// Fills VecQ16_BlockCount(count) blocks. Unused slots in the last block
+// decode to the block's centre.
+void
+VecQ16_Encode(VecSoA const& in, VecQ16Block* out, size_t count, int thread_count = 0);
+
+
+void
+VecQ16_Decode(VecQ16Block const* in, VecSoA const& out, size_t count, int thread_count = 0);
+
+
+// Rotates every Vec by R, in place. Each block's points are rotated into
+// float scratch and requantised against their own new bounds, so repeated
+// rotation adds one quantisation step per call and the extent never grows.
+void
+VecQ16_Rotate(Rotor const& R, VecQ16Block* blocks, size_t count, int thread_count = 0);
+
+
+// Normalises every Vec in place. Blocks are rescaled to the unit cube. Zero
+// vectors stay zero.
+void
+VecQ16_Normalise(VecQ16Block* blocks, size_t count, int thread_count = 0);
+
+
+// distance[i] = Vec_Distance(v[i], point)
+void
+VecQ16_Distance(VecQ16Block const* blocks, Vec const& point, float* distance, size_t count, int thread_count = 0);
@@ -0,0 +1,143 @@
+#include "GeometricAlgebra/cpu_dispatch.h"
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+static char const* const path_names[CpuPath_Count] = {
+    "scalar",
+    "sse4",
+    "avx2",
+    "avx512",
+};
+
+
+// __builtin_cpu_supports reads data that __builtin_cpu_init fills in. The
+// runtime normally does that from a constructor, but detection can run from
+// another static initialiser before it, so call it first. It is idempotent.
+static void
+InitCpuFeatures()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+#endif
+}
+
+
+bool
+Cpu_Supports(CpuPath path)
+{
+    InitCpuFeatures();
+    switch (path)
+    {
+    case CpuPath_Scalar:
+        return true;
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    case CpuPath_SSE4:
+        return __builtin_cpu_supports("sse4.1");
+    case CpuPath_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case CpuPath_AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+
+bool
+Cpu_HasF16C()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    InitCpuFeatures();
+    return __builtin_cpu_supports("f16c");
+#else
+    return false;
+#endif
+}
+
+
+CpuPath
+Cpu_DetectPath()
+{
+    for (int path = CpuPath_Count - 1; path > CpuPath_Scalar; --path)
+    {
+        if (Cpu_Supports((CpuPath)path))
+        {
+            return (CpuPath)path;
+        }
+    }
+    return CpuPath_Scalar;
+}
+
+
+static CpuPath
+InitialPath()
+{
+    auto detected = Cpu_DetectPath();
+    auto forced   = getenv("GA_CPU_PATH");
+    if (!forced || !*forced)
+    {
+        return detected;
+    }
+
+    for (int path = 0; path < CpuPath_Count; ++path)
+    {
+        if (strcmp(forced, path_names[path]) == 0)
+        {
+            if (Cpu_Supports((CpuPath)path))
+            {
+                return (CpuPath)path;
+            }
+            fprintf(stderr, "GA_CPU_PATH=%s is not supported on this CPU, using %s\n", forced, path_names[detected]);
+            return detected;
+        }
+    }
+
+    fprintf(stderr, "GA_CPU_PATH=%s is not a known path, using %s\n", forced, path_names[detected]);
+    return detected;
+}
+
+
+static std::atomic<int>&
+ActivePath()
+{
+    static std::atomic<int> path(InitialPath());
+    return path;
+}
+
+
+// Detect at library load so the first kernel call does not pay for it.
+static int const detect_at_init = (ActivePath(), 0);
+
+
+CpuPath
+Cpu_ActivePath()
+{
+    return (CpuPath)ActivePath().load(std::memory_order_relaxed);
+}
+
+
+bool
+Cpu_SetPath(CpuPath path)
+{
+    if (path < 0 || path >= CpuPath_Count || !Cpu_Supports(path))
+    {
+        return false;
+    }
+    ActivePath().store(path, std::memory_order_relaxed);
+    return true;
+}
+
+
+char const*
+Cpu_PathName(CpuPath path)
+{
+    if (path < 0 || path >= CpuPath_Count)
+    {
+        return "unknown";
+    }
+    return path_names[path];
+}
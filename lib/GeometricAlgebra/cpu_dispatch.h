@@ -0,0 +1,67 @@
+#pragma once
+
+// Runtime selection of the instruction set used by the dispatched batch
+// kernels (see batch_ops.h).
+//
+// The best path the CPU and OS support is detected once, the first time any
+// of these functions or a dispatched kernel runs. Setting the environment
+// variable GA_CPU_PATH to "scalar", "sse4", "avx2" or "avx512" forces that
+// path instead, provided the CPU supports it; otherwise a warning is printed
+// and the detected path is kept.
+
+
+// Compile the functions between GA_TARGET_BEGIN("isa") and GA_TARGET_END
+// for that instruction set, without -m flags for the whole file. Only call
+// them after checking the CPU supports it.
+#if defined(__clang__)
+#define GA_TARGET_BEGIN(isa) _Pragma("clang attribute push (__attribute__((target(\"" isa "\"))), apply_to = function)")
+#define GA_TARGET_END        _Pragma("clang attribute pop")
+#else
+#define GA_PRAGMA(x)         _Pragma(#x)
+#define GA_TARGET_BEGIN(isa) _Pragma("GCC push_options") GA_PRAGMA(GCC target(isa))
+#define GA_TARGET_END        _Pragma("GCC pop_options")
+#endif
+
+
+enum CpuPath
+{
+    CpuPath_Scalar,
+    CpuPath_SSE4,
+    CpuPath_AVX2,
+    CpuPath_AVX512,
+
+    CpuPath_Count
+};
+
+
+// The best path this machine supports, ignoring any override.
+CpuPath
+Cpu_DetectPath();
+
+
+// True if this machine can run the given path.
+bool
+Cpu_Supports(CpuPath path);
+
+
+// The path the batch kernels are currently using.
+CpuPath
+Cpu_ActivePath();
+
+
+// Forces the batch kernels onto a path. Returns false, leaving the active
+// path unchanged, if the machine does not support it. Intended for tests and
+// benchmarks. Safe to call from any thread: kernels read the path once per
+// thread chunk, so a batch call already in progress may finish some chunks
+// on the old path, with results that differ only by rounding.
+bool
+Cpu_SetPath(CpuPath path);
+
+
+char const*
+Cpu_PathName(CpuPath path);
+
+
+// True if the CPU has the F16C half-precision conversion instructions.
+bool
+Cpu_HasF16C();
@@ -0,0 +1,148 @@
+#include "GeometricAlgebra/euler_cache.h"
+#include <cassert>
+#include <math.h>
+#include <stdlib.h>
+
+
+EulerCache*
+EulerCache_Create(int32_t ticks_per_turn, uint32_t slot_count)
+{
+    assert(ticks_per_turn > 0 && ticks_per_turn <= (1 << 20));
+
+    auto cache              = (EulerCache*)malloc(sizeof(EulerCache));
+    cache->ticks_per_turn   = ticks_per_turn;
+    cache->radians_per_tick = (float)(2.0 * M_PI / ticks_per_turn);
+    cache->stats            = { 0, 0 };
+
+    // Same half-angle as RotorFromEuler: cos(-a / 2), sin(-a / 2).
+    auto period      = 2 * ticks_per_turn;
+    cache->half_cos  = (float*)malloc(period * sizeof(float));
+    cache->half_sin  = (float*)malloc(period * sizeof(float));
+    for (int32_t k = 0; k < period; ++k)
+    {
+        auto a             = k * cache->radians_per_tick;
+        cache->half_cos[k] = cosf(-a / 2.0f);
+        cache->half_sin[k] = sinf(-a / 2.0f);
+    }
+
+    cache->slots     = nullptr;
+    cache->slot_mask = 0;
+    if (slot_count > 0)
+    {
+        uint32_t size = 2;
+        while (size < slot_count)
+        {
+            size <<= 1;
+        }
+        cache->slots     = (EulerCacheSlot*)malloc(size * sizeof(EulerCacheSlot));
+        cache->slot_mask = size - 1;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            cache->slots[i].valid = 0;
+        }
+    }
+
+    return cache;
+}
+
+
+void
+EulerCache_Destroy(EulerCache* cache)
+{
+    free(cache->half_cos);
+    free(cache->half_sin);
+    free(cache->slots);
+    free(cache);
+}
+
+
+static inline int32_t
+Wrap(int32_t ticks, int32_t period)
+{
+    auto k = ticks % period;
+    return k < 0 ? k + period : k;
+}
+
+
+// RotorFromEuler with its two Geo_Muls expanded. The yaw (e13) and pitch
+// (e23) rotors leave most terms of each product zero.
+static inline Rotor
+Combine(float cy, float sy, float cp, float sp, float cr, float sr)
+{
+    Rotor A(cy * cp, sy * sp, cp * sy, cy * sp);
+    Geo_Normalise(A);
+
+    Rotor R(A.s * cr - A.B.e12 * sr,
+            A.s * sr + cr * A.B.e12,
+            cr * A.B.e13 - A.B.e23 * sr,
+            A.B.e13 * sr + cr * A.B.e23);
+    Geo_Normalise(R);
+    return R;
+}
+
+
+Rotor
+EulerCache_Rotor(EulerCache* cache, int32_t yaw, int32_t pitch, int32_t roll)
+{
+    auto period = 2 * cache->ticks_per_turn;
+    yaw         = Wrap(yaw, period);
+    pitch       = Wrap(pitch, period);
+    roll        = Wrap(roll, period);
+
+    cache->stats.lookups++;
+
+    EulerCacheSlot* set = nullptr;
+    if (cache->slots)
+    {
+        // Ticks fit in 21 bits (period <= 2^21), so the key packs into 64.
+        // Mixed with the splitmix64 finaliser.
+        uint64_t h = (uint64_t)yaw << 42 | (uint64_t)pitch << 21 | (uint64_t)roll;
+        h          = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h          = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        h          = h ^ (h >> 31);
+
+        // Two-way sets, most recently used first.
+        set = &cache->slots[(uint32_t)h & cache->slot_mask & ~1u];
+        for (int way = 0; way < 2; ++way)
+        {
+            auto& slot = set[way];
+            if (slot.valid && slot.yaw == yaw && slot.pitch == pitch && slot.roll == roll)
+            {
+                cache->stats.hits++;
+                if (way == 1)
+                {
+                    auto mru = set[1];
+                    set[1]   = set[0];
+                    set[0]   = mru;
+                }
+                return set[0].R;
+            }
+        }
+    }
+
+    auto R = Combine(cache->half_cos[yaw], cache->half_sin[yaw],
+                     cache->half_cos[pitch], cache->half_sin[pitch],
+                     cache->half_cos[roll], cache->half_sin[roll]);
+
+    if (set)
+    {
+        set[1]       = set[0];
+        set[0].yaw   = yaw;
+        set[0].pitch = pitch;
+        set[0].roll  = roll;
+        set[0].valid = 1;
+        set[0].R     = R;
+    }
+    return R;
+}
+
+
+Rotor
+EulerCache_RotorFromEuler(EulerCache* cache, float yaw, float pitch, float roll)
+{
+    auto k = 1.0f / cache->radians_per_tick;
+    return EulerCache_Rotor(cache,
+                            (int32_t)lrintf(yaw * k),
+                            (int32_t)lrintf(pitch * k),
+                            (int32_t)lrintf(roll * k));
+}
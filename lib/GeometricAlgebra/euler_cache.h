@@ -0,0 +1,91 @@
+#pragma once
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <stdint.h>
+
+// Memoised RotorFromEuler for angles that arrive in fixed steps (encoder
+// ticks).
+//
+// Two levels:
+//  1. Half-angle cos/sin tables indexed by tick, shared by the three axes.
+//     A miss combines three table entries with the closed form of
+//     RotorFromEuler's two Geo_Muls, so it never calls a trig function.
+//  2. A two-way set-associative, hashed cache of finished rotors keyed on
+//     the three tick counts. A hit is a hash and at most two compares.
+//
+// Results match RotorFromEuler(ticks * radians_per_tick, ...) to within
+// rounding. A cache must only be used from one thread at a time.
+
+
+struct EulerCacheSlot
+{
+    int32_t yaw, pitch, roll;
+    int32_t valid;
+    Rotor   R;
+};
+
+
+struct EulerCacheStats
+{
+    uint64_t lookups;
+    uint64_t hits;
+};
+
+
+struct EulerCache
+{
+    int32_t ticks_per_turn;
+    float   radians_per_tick;
+
+    // 2 * ticks_per_turn entries: the half-angle repeats every two turns.
+    float* half_cos;
+    float* half_sin;
+
+    EulerCacheSlot* slots;
+    uint32_t        slot_mask;
+
+    EulerCacheStats stats;
+};
+
+
+// ticks_per_turn is the number of ticks in one full revolution, at most
+// 2^20. slot_count is rounded up to a power of two (at least 2); 0 disables
+// the result cache and leaves only the tables.
+EulerCache*
+EulerCache_Create(int32_t ticks_per_turn, uint32_t slot_count = 4096);
+
+
+void
+EulerCache_Destroy(EulerCache* cache);
+
+
+// Rotor for the given tick counts, any of which may be negative or span
+// several turns.
+Rotor
+EulerCache_Rotor(EulerCache* cache, int32_t yaw, int32_t pitch, int32_t roll);
+
+
+// Rounds each angle (radians) to the nearest tick, then looks it up.
+Rotor
+EulerCache_RotorFromEuler(EulerCache* cache, float yaw, float pitch, float roll);
+
+
+inline EulerCacheStats
+EulerCache_Stats(EulerCache const* cache)
+{
+    return cache->stats;
+}
+
+
+inline float
+EulerCache_HitRate(EulerCache const* cache)
+{
+    auto const& s = cache->stats;
+    return s.lookups ? (float)((double)s.hits / (double)s.lookups) : 0.0f;
+}
+
+
+inline void
+EulerCache_ResetStats(EulerCache* cache)
+{
+    cache->stats = { 0, 0 };
+}
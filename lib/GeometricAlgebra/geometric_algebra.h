@@ -224,6 +224,23 @@ Vec_Wedge(Vec const& a, Vec const& b)
 }
 
 
+// The signed volume spanned by a and the plane B.
+inline TriVector
+Vec_Wedge(Vec const& a, BiVector const& B)
+{
+    return { a.x * B.e23 - a.y * B.e13 + a.z * B.e12 };
+}
+
+
+// Scalar product of the two planes' components. Equal to the dot product
+// of their normals, and to minus the geometric inner product A.B.
+inline float
+BiVector_Dot(BiVector const& A, BiVector const& B)
+{
+    return A.e12 * B.e12 + A.e13 * B.e13 + A.e23 * B.e23;
+}
+
+
 inline std::tuple<float, BiVector>
 Vec_Mul(Vec const& a, Vec const& b)
 {
@@ -462,6 +479,43 @@ ToMatrix4(Rotor const& R)
 }
 
 
+// Inverse of ToMatrix4. m must hold a rotation in the layout ToMatrix4
+// writes: m[4 * i + k] is component k of the rotated basis vector e(i+1).
+//
+// Uses the trace method, choosing the best conditioned of the four
+// diagonal combinations so accuracy holds right up to half-turns. The
+// choice is written as selects rather than branches so the batch version
+// (Batch_RotorFromMatrix4) can share it. The returned rotor has s >= 0.
+inline Rotor
+RotorFromMatrix4(Matrix4 const& m)
+{
+    // Q[r][c] = m[4 * c + r]
+    auto q00 = m[0], q11 = m[5], q22 = m[10];
+    auto q01 = m[4], q10 = m[1];
+    auto q02 = m[8], q20 = m[2];
+    auto q12 = m[9], q21 = m[6];
+
+    bool c22 = q22 < 0.0f;
+    bool c01 = q11 < q00;
+    bool cz  = q00 < -q11;
+
+    // Unscaled quaternion (w, x, y, z) for each case; the largest component
+    // is t, and the rest follow from the off-diagonal sums and differences.
+    auto t = c22 ? (c01 ? 1.0f + q00 - q11 - q22 : 1.0f - q00 + q11 - q22)
+                 : (cz ? 1.0f - q00 - q11 + q22 : 1.0f + q00 + q11 + q22);
+    auto w = c22 ? (c01 ? q21 - q12 : q02 - q20) : (cz ? q10 - q01 : t);
+    auto x = c22 ? (c01 ? t : q01 + q10) : (cz ? q02 + q20 : q21 - q12);
+    auto y = c22 ? (c01 ? q01 + q10 : t) : (cz ? q12 + q21 : q02 - q20);
+    auto z = c22 ? (c01 ? q02 + q20 : q12 + q21) : (cz ? t : q10 - q01);
+
+    auto k = 0.5f / sqrtf(t);
+    k      = w < 0.0f ? -k : k;
+
+    // Quaternion (w, x, y, z) is the rotor s - x e23 + y e13 - z e12.
+    return Rotor(w * k, -z * k, y * k, -x * k);
+}
+
+
 inline Rotor
 RotorFromEuler(float yaw, float pitch, float roll)
 {
@@ -0,0 +1,256 @@
+#include "GeometricAlgebra/imu_pipeline.h"
+#include "GeometricAlgebra/spsc_ring.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+struct ImuPipeline
+{
+    ImuPipelineConfig config;
+
+    SpscRing<ImuRawSample> input;
+    SpscRing<Rotor>        euler;
+    SpscRing<Rotor>        calibrated;
+    SpscRing<Matrix4>      output;
+
+    // done[0] is set by Close, done[i + 1] when stage i has drained.
+    std::atomic<bool> done[4];
+    std::atomic<bool> abort;
+
+    // Backoff waits across all stages, for ImuPipeline_IdleWaits.
+    std::atomic<uint64_t> waits;
+
+    std::thread stages[3];
+
+    explicit ImuPipeline(ImuPipelineConfig const& c)
+        : config(c),
+          input(c.ring_capacity),
+          euler(c.ring_capacity),
+          calibrated(c.ring_capacity),
+          output(c.ring_capacity)
+    {
+        for (auto& d : this->done)
+        {
+            d.store(false, std::memory_order_relaxed);
+        }
+        this->abort.store(false, std::memory_order_relaxed);
+        this->waits.store(0, std::memory_order_relaxed);
+    }
+};
+
+
+// Spin briefly, then yield, then sleep. Spinning and yielding keep latency
+// low when the next batch is moments away; once the stream has been idle
+// for a while the stage sleeps, doubling up to IMU_BACKOFF_MAX_SLEEP_US, so
+// an idle pipeline costs next to no CPU. The price is up to that much extra
+// latency on the first batch after an idle period.
+#define IMU_BACKOFF_SPINS        64
+#define IMU_BACKOFF_YIELDS       64
+#define IMU_BACKOFF_MAX_SLEEP_US 1000
+
+struct Backoff
+{
+    int spins    = 0;
+    int sleep_us = 0;
+
+    void
+    Wait()
+    {
+        if (this->spins < IMU_BACKOFF_SPINS)
+        {
+#if defined(__SSE2__)
+            _mm_pause();
+#endif
+            this->spins++;
+        }
+        else if (this->spins < IMU_BACKOFF_SPINS + IMU_BACKOFF_YIELDS)
+        {
+            std::this_thread::yield();
+            this->spins++;
+        }
+        else
+        {
+            this->sleep_us = this->sleep_us == 0 ? 10 : this->sleep_us * 2;
+            this->sleep_us = this->sleep_us < IMU_BACKOFF_MAX_SLEEP_US ? this->sleep_us : IMU_BACKOFF_MAX_SLEEP_US;
+            std::this_thread::sleep_for(std::chrono::microseconds(this->sleep_us));
+        }
+    }
+
+    void
+    Reset()
+    {
+        this->spins    = 0;
+        this->sleep_us = 0;
+    }
+};
+
+
+template <typename In, typename Out, typename Fn>
+static void
+RunStage(ImuPipeline* p, SpscRing<In>& in, SpscRing<Out>& out, int stage, Fn fn)
+{
+    auto const batch = p->config.batch_size;
+
+    std::vector<In>  a(batch);
+    std::vector<Out> b(batch);
+    Backoff          backoff;
+
+    while (!p->abort.load(std::memory_order_relaxed))
+    {
+        auto n = in.Pop(a.data(), batch);
+        if (n == 0)
+        {
+            // Check for an empty ring again after seeing the upstream flag,
+            // since the last batch may have landed in between.
+            if (p->done[stage].load(std::memory_order_acquire) && in.Size() == 0)
+            {
+                break;
+            }
+            p->waits.fetch_add(1, std::memory_order_relaxed);
+            backoff.Wait();
+            continue;
+        }
+        backoff.Reset();
+
+        fn(a.data(), b.data(), n);
+
+        size_t sent = 0;
+        while (sent < n && !p->abort.load(std::memory_order_relaxed))
+        {
+            sent += out.Push(b.data() + sent, n - sent);
+            if (sent < n)
+            {
+                p->waits.fetch_add(1, std::memory_order_relaxed);
+                backoff.Wait();
+            }
+        }
+        backoff.Reset();
+    }
+
+    p->done[stage + 1].store(true, std::memory_order_release);
+}
+
+
+static void
+PinToCpu(std::thread& thread, int cpu)
+{
+#if defined(__linux__)
+    if (cpu < 0)
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+
+ImuPipeline*
+ImuPipeline_Create(ImuPipelineConfig const& config)
+{
+    auto p = new ImuPipeline(config);
+    if (p->config.batch_size == 0)
+    {
+        p->config.batch_size = 1;
+    }
+
+    auto const scale = config.radians_per_count;
+    auto const C     = config.calibration;
+
+    p->stages[0] = std::thread([p, scale]() {
+        RunStage(p, p->input, p->euler, 0, [scale](ImuRawSample const* in, Rotor* out, size_t n) {
+            for (size_t i = 0; i < n; ++i)
+            {
+                out[i] = RotorFromEuler(in[i].yaw * scale, in[i].pitch * scale, in[i].roll * scale);
+            }
+        });
+    });
+
+    p->stages[1] = std::thread([p, C]() {
+        RunStage(p, p->euler, p->calibrated, 1, [C](Rotor const* in, Rotor* out, size_t n) {
+            for (size_t i = 0; i < n; ++i)
+            {
+                out[i] = Geo_Mul(C, in[i]);
+            }
+        });
+    });
+
+    p->stages[2] = std::thread([p]() {
+        RunStage(p, p->calibrated, p->output, 2, [](Rotor const* in, Matrix4* out, size_t n) {
+            for (size_t i = 0; i < n; ++i)
+            {
+                out[i] = ToMatrix4(in[i]);
+            }
+        });
+    });
+
+    for (int i = 0; i < 3; ++i)
+    {
+        PinToCpu(p->stages[i], config.stage_cpu[i]);
+    }
+
+    return p;
+}
+
+
+void
+ImuPipeline_Destroy(ImuPipeline* pipeline)
+{
+    pipeline->abort.store(true, std::memory_order_relaxed);
+    for (auto& stage : pipeline->stages)
+    {
+        stage.join();
+    }
+    delete pipeline;
+}
+
+
+size_t
+ImuPipeline_Push(ImuPipeline* pipeline, ImuRawSample const* samples, size_t n)
+{
+    return pipeline->input.Push(samples, n);
+}
+
+
+void
+ImuPipeline_Close(ImuPipeline* pipeline)
+{
+    pipeline->done[0].store(true, std::memory_order_release);
+}
+
+
+size_t
+ImuPipeline_Pop(ImuPipeline* pipeline, Matrix4* out, size_t max)
+{
+    return pipeline->output.Pop(out, max);
+}
+
+
+bool
+ImuPipeline_Finished(ImuPipeline* pipeline)
+{
+    return pipeline->done[3].load(std::memory_order_acquire) && pipeline->output.Size() == 0;
+}
+
+
+uint64_t
+ImuPipeline_IdleWaits(ImuPipeline* pipeline)
+{
+    return pipeline->waits.load(std::memory_order_relaxed);
+}
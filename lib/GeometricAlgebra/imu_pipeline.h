@@ -0,0 +1,99 @@
+#pragma once
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+
+// Streaming IMU orientation pipeline.
+//
+// Samples flow through three stages, each on its own thread, connected by
+// lock-free SPSC rings:
+//
+//   Push -> [decode + RotorFromEuler] -> [Geo_Mul(calibration, R)] -> [ToMatrix4] -> Pop
+//
+// Stages hand over batches of up to `batch_size` samples, so each sample is
+// still in cache when the next stage picks it up. When a ring fills, the
+// stage feeding it waits, and that backpressure reaches Push, which then
+// accepts fewer samples. Output order matches input order.
+//
+// Idle stages spin, then yield, then sleep for up to a millisecond at a time,
+// so an idle pipeline uses almost no CPU but the first batch after a pause
+// can be delayed by up to that long.
+
+
+// Raw encoder angles. Decoded as count * radians_per_count.
+struct ImuRawSample
+{
+    int32_t yaw;
+    int32_t pitch;
+    int32_t roll;
+};
+
+
+struct ImuPipelineConfig
+{
+    float  radians_per_count;
+    Rotor  calibration;
+    size_t ring_capacity;
+    size_t batch_size;
+
+    // CPU to pin each stage thread to, or -1 to leave it unpinned.
+    int stage_cpu[3];
+};
+
+
+inline ImuPipelineConfig
+ImuPipeline_DefaultConfig()
+{
+    ImuPipelineConfig config;
+    config.radians_per_count = 1.0f;
+    config.calibration       = Rotor();
+    config.ring_capacity     = 1024;
+    config.batch_size        = 64;
+    config.stage_cpu[0]      = -1;
+    config.stage_cpu[1]      = -1;
+    config.stage_cpu[2]      = -1;
+    return config;
+}
+
+
+struct ImuPipeline;
+
+
+// Starts the stage threads.
+ImuPipeline*
+ImuPipeline_Create(ImuPipelineConfig const& config);
+
+
+// Stops the stage threads, discarding anything still in flight.
+void
+ImuPipeline_Destroy(ImuPipeline* pipeline);
+
+
+// Producer side; call from one thread only. Never blocks. Returns the number
+// of samples accepted, which is less than n when the pipeline is backed up.
+size_t
+ImuPipeline_Push(ImuPipeline* pipeline, ImuRawSample const* samples, size_t n);
+
+
+// Signals that no more samples will be pushed. In-flight samples still
+// drain through to the output.
+void
+ImuPipeline_Close(ImuPipeline* pipeline);
+
+
+// Consumer side; call from one thread only. Never blocks. Returns the number
+// of matrices written to out.
+size_t
+ImuPipeline_Pop(ImuPipeline* pipeline, Matrix4* out, size_t max);
+
+
+// True once the pipeline has been closed and every sample has been popped.
+bool
+ImuPipeline_Finished(ImuPipeline* pipeline);
+
+
+// Number of times any stage has waited, for input or for room downstream,
+// since Create. Once the backoff reaches its longest sleep an idle stage
+// adds about one per millisecond.
+uint64_t
+ImuPipeline_IdleWaits(ImuPipeline* pipeline);
@@ -0,0 +1,352 @@
+#include "GeometricAlgebra/intersection.h"
+#include <atomic>
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+static inline Vec
+Load(VecSoA const& v, size_t i)
+{
+    return { v.x[i], v.y[i], v.z[i] };
+}
+
+
+static inline void
+Store(VecSoA const& v, size_t i, Vec const& u)
+{
+    v.x[i] = u.x;
+    v.y[i] = u.y;
+    v.z[i] = u.z;
+}
+
+
+// Normal vector n of plane N, such that v ^ N == (v . n) e123.
+static inline Vec
+Normal(BiVector const& N)
+{
+    return { N.e23, -N.e13, N.e12 };
+}
+
+
+static inline uint8_t
+RayPlane(Vec const& O, Vec const& D, Vec const& P, BiVector const& B, float t_max, float& t)
+{
+    auto DB = Vec_Wedge(D, B).e123;
+    auto OB = Vec_Wedge(O - P, B).e123;
+
+    t = DB != 0.0f ? -OB / DB : INFINITY;
+    return DB != 0.0f && t >= 0.0f && t <= t_max;
+}
+
+
+static inline uint8_t
+LineLine(Vec const& P1, Vec const& D1, Vec const& P2, Vec const& D2, float max_distance2, Vec& X1, Vec& X2)
+{
+    auto N  = Vec_Wedge(D1, D2);
+    auto NN = BiVector_Dot(N, N);
+    auto w  = P2 - P1;
+
+    if (NN == 0.0f)
+    {
+        X1 = P1;
+        X2 = P2;
+        return 0;
+    }
+
+    auto s = BiVector_Dot(Vec_Wedge(w, D2), N) / NN;
+    auto t = BiVector_Dot(Vec_Wedge(w, D1), N) / NN;
+
+    X1 = P1 + D1 * s;
+    X2 = P2 + D2 * t;
+
+    auto d = X2 - X1;
+    return Vec_Dot(d, d) <= max_distance2;
+}
+
+
+static inline uint8_t
+PointInTriangle(Vec const& P, Vec const& A, Vec const& B, Vec const& C, float tolerance)
+{
+    auto N  = Vec_Wedge(B - A, C - A);
+    auto n  = Normal(N);
+    auto NN = BiVector_Dot(N, N);
+
+    auto vab = Vec_Wedge(n, Vec_Wedge(B - A, P - A)).e123;
+    auto vbc = Vec_Wedge(n, Vec_Wedge(C - B, P - B)).e123;
+    auto vca = Vec_Wedge(n, Vec_Wedge(A - C, P - C)).e123;
+    auto h   = Vec_Wedge(P - A, N).e123;
+
+    return NN > 0.0f && vab >= 0.0f && vbc >= 0.0f && vca >= 0.0f
+        && h * h <= tolerance * tolerance * NN;
+}
+
+
+#if defined(__SSE2__)
+
+struct Vec4
+{
+    __m128 x, y, z;
+};
+
+
+struct BiVector4
+{
+    __m128 e12, e13, e23;
+};
+
+
+static inline Vec4
+Load4(VecSoA const& v, size_t i)
+{
+    return { _mm_loadu_ps(v.x + i), _mm_loadu_ps(v.y + i), _mm_loadu_ps(v.z + i) };
+}
+
+
+static inline void
+Store4(VecSoA const& v, size_t i, Vec4 const& u)
+{
+    _mm_storeu_ps(v.x + i, u.x);
+    _mm_storeu_ps(v.y + i, u.y);
+    _mm_storeu_ps(v.z + i, u.z);
+}
+
+
+static inline Vec4
+Sub4(Vec4 const& a, Vec4 const& b)
+{
+    return { _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) };
+}
+
+
+static inline Vec4
+MulAdd4(Vec4 const& p, Vec4 const& d, __m128 s)
+{
+    return {
+        _mm_add_ps(p.x, _mm_mul_ps(d.x, s)),
+        _mm_add_ps(p.y, _mm_mul_ps(d.y, s)),
+        _mm_add_ps(p.z, _mm_mul_ps(d.z, s))
+    };
+}
+
+
+static inline __m128
+Dot4(Vec4 const& a, Vec4 const& b)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+}
+
+
+static inline BiVector4
+Wedge4(Vec4 const& a, Vec4 const& b)
+{
+    return {
+        _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(b.x, a.y)),
+        _mm_sub_ps(_mm_mul_ps(a.x, b.z), _mm_mul_ps(b.x, a.z)),
+        _mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(b.y, a.z))
+    };
+}
+
+
+static inline __m128
+Wedge4(Vec4 const& a, BiVector4 const& B)
+{
+    return _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a.x, B.e23), _mm_mul_ps(a.y, B.e13)), _mm_mul_ps(a.z, B.e12));
+}
+
+
+static inline __m128
+Dot4(BiVector4 const& A, BiVector4 const& B)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(A.e12, B.e12), _mm_mul_ps(A.e13, B.e13)), _mm_mul_ps(A.e23, B.e23));
+}
+
+
+static inline Vec4
+Normal4(BiVector4 const& N)
+{
+    return { N.e23, _mm_sub_ps(_mm_setzero_ps(), N.e13), N.e12 };
+}
+
+
+// Writes four mask bytes and returns how many were set.
+static inline size_t
+StoreMask4(uint8_t* hit, __m128 mask)
+{
+    int bits = _mm_movemask_ps(mask);
+    hit[0]   = bits & 1;
+    hit[1]   = (bits >> 1) & 1;
+    hit[2]   = (bits >> 2) & 1;
+    hit[3]   = (bits >> 3) & 1;
+    return __builtin_popcount(bits);
+}
+
+#endif
+
+
+size_t
+Intersect_RayPlane(VecSoA const&      origin,
+                   VecSoA const&      direction,
+                   VecSoA const&      plane_point,
+                   BiVectorSoA const& plane,
+                   size_t             count,
+                   float              t_max,
+                   float*             t,
+                   uint8_t*           hit,
+                   int                thread_count)
+{
+    std::atomic<size_t> hits(0);
+
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        size_t local = 0;
+        size_t i     = begin;
+#if defined(__SSE2__)
+        auto const zero = _mm_setzero_ps();
+        auto const tmax = _mm_set1_ps(t_max);
+        for (; i + 4 <= end; i += 4)
+        {
+            BiVector4 B = { _mm_loadu_ps(plane.e12 + i), _mm_loadu_ps(plane.e13 + i), _mm_loadu_ps(plane.e23 + i) };
+
+            auto DB = Wedge4(Load4(direction, i), B);
+            auto OB = Wedge4(Sub4(Load4(origin, i), Load4(plane_point, i)), B);
+
+            auto valid = _mm_cmpneq_ps(DB, zero);
+            auto ti    = _mm_div_ps(_mm_sub_ps(zero, OB), DB);
+            ti         = _mm_or_ps(_mm_and_ps(valid, ti), _mm_andnot_ps(valid, _mm_set1_ps(INFINITY)));
+            _mm_storeu_ps(t + i, ti);
+
+            auto mask = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(ti, zero), _mm_cmple_ps(ti, tmax)));
+            local += StoreMask4(hit + i, mask);
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            BiVector B = { plane.e12[i], plane.e13[i], plane.e23[i] };
+            hit[i]     = RayPlane(Load(origin, i), Load(direction, i), Load(plane_point, i), B, t_max, t[i]);
+            local += hit[i];
+        }
+        hits += local;
+    });
+
+    return hits;
+}
+
+
+size_t
+Intersect_LineLine(VecSoA const& p1,
+                   VecSoA const& d1,
+                   VecSoA const& p2,
+                   VecSoA const& d2,
+                   size_t        count,
+                   float         max_distance,
+                   VecSoA const& closest1,
+                   VecSoA const& closest2,
+                   uint8_t*      hit,
+                   int           thread_count)
+{
+    std::atomic<size_t> hits(0);
+    auto const          max_distance2 = max_distance * max_distance;
+
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        size_t local = 0;
+        size_t i     = begin;
+#if defined(__SSE2__)
+        auto const zero  = _mm_setzero_ps();
+        auto const limit = _mm_set1_ps(max_distance2);
+        for (; i + 4 <= end; i += 4)
+        {
+            auto P1 = Load4(p1, i);
+            auto D1 = Load4(d1, i);
+            auto P2 = Load4(p2, i);
+            auto D2 = Load4(d2, i);
+
+            auto N  = Wedge4(D1, D2);
+            auto NN = Dot4(N, N);
+            auto w  = Sub4(P2, P1);
+
+            // Parallel lanes get s = t = 0, i.e. the closest points are P1, P2.
+            auto valid = _mm_cmpneq_ps(NN, zero);
+            auto inv   = _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), NN));
+            auto s     = _mm_mul_ps(Dot4(Wedge4(w, D2), N), inv);
+            auto t     = _mm_mul_ps(Dot4(Wedge4(w, D1), N), inv);
+
+            auto X1 = MulAdd4(P1, D1, s);
+            auto X2 = MulAdd4(P2, D2, t);
+            Store4(closest1, i, X1);
+            Store4(closest2, i, X2);
+
+            auto d    = Sub4(X2, X1);
+            auto mask = _mm_and_ps(valid, _mm_cmple_ps(Dot4(d, d), limit));
+            local += StoreMask4(hit + i, mask);
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            Vec X1, X2;
+            hit[i] = LineLine(Load(p1, i), Load(d1, i), Load(p2, i), Load(d2, i), max_distance2, X1, X2);
+            Store(closest1, i, X1);
+            Store(closest2, i, X2);
+            local += hit[i];
+        }
+        hits += local;
+    });
+
+    return hits;
+}
+
+
+size_t
+Intersect_PointInTriangle(VecSoA const& p,
+                          VecSoA const& a,
+                          VecSoA const& b,
+                          VecSoA const& c,
+                          size_t        count,
+                          float         plane_tolerance,
+                          uint8_t*      hit,
+                          int           thread_count)
+{
+    std::atomic<size_t> hits(0);
+    auto const          tolerance2 = plane_tolerance * plane_tolerance;
+
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        size_t local = 0;
+        size_t i     = begin;
+#if defined(__SSE2__)
+        auto const zero = _mm_setzero_ps();
+        auto const tol2 = _mm_set1_ps(tolerance2);
+        for (; i + 4 <= end; i += 4)
+        {
+            auto P = Load4(p, i);
+            auto A = Load4(a, i);
+            auto B = Load4(b, i);
+            auto C = Load4(c, i);
+
+            auto N  = Wedge4(Sub4(B, A), Sub4(C, A));
+            auto n  = Normal4(N);
+            auto NN = Dot4(N, N);
+
+            auto vab = Wedge4(n, Wedge4(Sub4(B, A), Sub4(P, A)));
+            auto vbc = Wedge4(n, Wedge4(Sub4(C, B), Sub4(P, B)));
+            auto vca = Wedge4(n, Wedge4(Sub4(A, C), Sub4(P, C)));
+            auto h   = Wedge4(Sub4(P, A), N);
+
+            auto mask = _mm_cmpgt_ps(NN, zero);
+            mask      = _mm_and_ps(mask, _mm_cmpge_ps(vab, zero));
+            mask      = _mm_and_ps(mask, _mm_cmpge_ps(vbc, zero));
+            mask      = _mm_and_ps(mask, _mm_cmpge_ps(vca, zero));
+            mask      = _mm_and_ps(mask, _mm_cmple_ps(_mm_mul_ps(h, h), _mm_mul_ps(tol2, NN)));
+            local += StoreMask4(hit + i, mask);
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            hit[i] = PointInTriangle(Load(p, i), Load(a, i), Load(b, i), Load(c, i), plane_tolerance);
+            local += hit[i];
+        }
+        hits += local;
+    });
+
+    return hits;
+}
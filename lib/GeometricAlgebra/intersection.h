@@ -0,0 +1,68 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+
+// Batched intersection queries built on the wedge product.
+//
+// Every kernel processes `count` independent queries from SoA inputs and
+// writes a hit mask: hit[i] is 1 when query i hits and 0 otherwise. The
+// return value is the number of hits. Work is vectorised four queries at a
+// time and split over `thread_count` threads (0 = one per hardware thread).
+
+
+// Ray O + tD against the plane through point P spanned by bivector B.
+//
+// The hit point X satisfies (X - P) ^ B = 0, which gives
+//   t = -((O - P) ^ B) / (D ^ B)
+// as a ratio of trivectors. Rays parallel to the plane miss. A hit needs
+// 0 <= t <= t_max; t[i] is written for every query, hit or not.
+size_t
+Intersect_RayPlane(VecSoA const&      origin,
+                   VecSoA const&      direction,
+                   VecSoA const&      plane_point,
+                   BiVectorSoA const& plane,
+                   size_t             count,
+                   float              t_max,
+                   float*             t,
+                   uint8_t*           hit,
+                   int                thread_count = 0);
+
+
+// Closest points between lines P1 + s D1 and P2 + t D2.
+//
+// With N = D1 ^ D2 and w = P2 - P1, the parameters are ratios of bivector
+// scalar products:
+//   s = <w ^ D2, N> / <N, N>,   t = <w ^ D1, N> / <N, N>
+// The closest points are written for every query. A hit means the lines are
+// not parallel and pass within max_distance of each other.
+size_t
+Intersect_LineLine(VecSoA const& p1,
+                   VecSoA const& d1,
+                   VecSoA const& p2,
+                   VecSoA const& d2,
+                   size_t        count,
+                   float         max_distance,
+                   VecSoA const& closest1,
+                   VecSoA const& closest2,
+                   uint8_t*      hit,
+                   int           thread_count = 0);
+
+
+// Point P against triangle ABC.
+//
+// With N = (B - A) ^ (C - A) and n its normal vector, P is inside when the
+// signed volumes ((B - A) ^ (P - A)) ^ n, ((C - B) ^ (P - B)) ^ n and
+// ((A - C) ^ (P - C)) ^ n are all non-negative, and its distance from the
+// plane, |(P - A) ^ N| / |N|, is at most plane_tolerance. Degenerate
+// triangles miss.
+size_t
+Intersect_PointInTriangle(VecSoA const& p,
+                          VecSoA const& a,
+                          VecSoA const& b,
+                          VecSoA const& c,
+                          size_t        count,
+                          float         plane_tolerance,
+                          uint8_t*      hit,
+                          int           thread_count = 0);
@@ -0,0 +1,247 @@
+#include "GeometricAlgebra/morton.h"
+#include "GeometricAlgebra/reduce.h"
+#include <assert.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+#define MORTON_RADIX_BITS 11
+#define MORTON_RADIX      (1u << MORTON_RADIX_BITS)
+#define MORTON_PASSES     ((3 * MORTON_BITS + MORTON_RADIX_BITS - 1) / MORTON_RADIX_BITS)
+
+
+// Fixed split of [0, count) into one chunk per thread, for work that keeps
+// per-chunk state. Like Batch_ParallelFor, it depends only on count and
+// thread_count.
+struct Chunks
+{
+    size_t count;
+    size_t size;
+    size_t total;
+
+    Chunks(size_t total, size_t grain, int thread_count)
+    {
+        auto threads = (size_t)Batch_ThreadCount(thread_count);
+        auto most    = (total + grain - 1) / grain;
+        this->count  = threads < most ? threads : most;
+        this->count  = this->count > 0 ? this->count : 1;
+        this->size   = (total + this->count - 1) / this->count;
+        this->total  = total;
+    }
+
+    size_t
+    Begin(size_t c) const
+    {
+        return c * this->size < this->total ? c * this->size : this->total;
+    }
+
+    size_t
+    End(size_t c) const
+    {
+        return this->Begin(c + 1);
+    }
+
+    // Runs fn(chunk) for every chunk, one thread each.
+    template <typename Fn>
+    void
+    Run(Fn&& fn) const
+    {
+        Batch_ParallelFor(this->count, 1, (int)this->count, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c)
+            {
+                fn(c);
+            }
+        });
+    }
+};
+
+
+void
+Morton_Bounds(VecSoA const& in, size_t count, Vec& lo, Vec& hi, int thread_count)
+{
+    auto stats = Reduce_Stats(in, count, Reduce_Bounds, thread_count);
+    lo         = stats.lo;
+    hi         = stats.hi;
+}
+
+
+static inline uint32_t
+Quantise(float v, float lo, float scale)
+{
+    auto q = (v - lo) * scale;
+    q      = q > 0.0f ? q : 0.0f; // Also catches NaN.
+    q      = q < 1023.0f ? q : 1023.0f;
+    return (uint32_t)q;
+}
+
+
+#if defined(__SSE2__)
+
+static inline __m128i
+Spread4(__m128i v)
+{
+    v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 16)), _mm_set1_epi32(0x030000ff));
+    v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 8)), _mm_set1_epi32(0x0300f00f));
+    v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 4)), _mm_set1_epi32(0x030c30c3));
+    v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 2)), _mm_set1_epi32(0x09249249));
+    return v;
+}
+
+
+static inline __m128i
+Quantise4(__m128 v, __m128 lo, __m128 scale)
+{
+    // Operand order matters: max/min return the second operand for NaN.
+    auto q = _mm_mul_ps(_mm_sub_ps(v, lo), scale);
+    q      = _mm_max_ps(q, _mm_setzero_ps());
+    q      = _mm_min_ps(q, _mm_set1_ps(1023.0f));
+    return _mm_cvttps_epi32(q);
+}
+
+#endif
+
+
+void
+Morton_Keys(VecSoA const& in, Vec const& lo, Vec const& hi, uint32_t* keys, size_t count, int thread_count)
+{
+    // Scale so the box maps onto [0, 1024); the far faces clamp to 1023.
+    Vec scale;
+    for (int k = 0; k < 3; ++k)
+    {
+        auto extent = hi[k] - lo[k];
+        scale[k]    = extent > 0.0f ? 1024.0f / extent : 0.0f;
+    }
+
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        size_t i = begin;
+
+#if defined(__SSE2__)
+        auto lx = _mm_set1_ps(lo.x), ly = _mm_set1_ps(lo.y), lz = _mm_set1_ps(lo.z);
+        auto sx = _mm_set1_ps(scale.x), sy = _mm_set1_ps(scale.y), sz = _mm_set1_ps(scale.z);
+        for (; i + 4 <= end; i += 4)
+        {
+            auto x = Spread4(Quantise4(_mm_loadu_ps(in.x + i), lx, sx));
+            auto y = Spread4(Quantise4(_mm_loadu_ps(in.y + i), ly, sy));
+            auto z = Spread4(Quantise4(_mm_loadu_ps(in.z + i), lz, sz));
+
+            auto key = _mm_or_si128(x, _mm_or_si128(_mm_slli_epi32(y, 1), _mm_slli_epi32(z, 2)));
+            _mm_storeu_si128((__m128i*)(keys + i), key);
+        }
+#endif
+
+        for (; i < end; ++i)
+        {
+            keys[i] = Morton_Encode(Quantise(in.x[i], lo.x, scale.x),
+                                    Quantise(in.y[i], lo.y, scale.y),
+                                    Quantise(in.z[i], lo.z, scale.z));
+        }
+    });
+}
+
+
+void
+Morton_Sort(uint32_t* keys, uint32_t* order, size_t count, int thread_count)
+{
+    assert(count <= UINT32_MAX);
+
+    Chunks                chunks(count, 16384, thread_count);
+    std::vector<uint32_t> key_scratch(count), order_scratch(count);
+    std::vector<uint32_t> histogram(chunks.count * MORTON_RADIX);
+
+    chunks.Run([&](size_t c) {
+        for (size_t i = chunks.Begin(c); i < chunks.End(c); ++i)
+        {
+            order[i] = (uint32_t)i;
+        }
+    });
+
+    uint32_t* src_key   = keys;
+    uint32_t* src_order = order;
+    uint32_t* dst_key   = key_scratch.data();
+    uint32_t* dst_order = order_scratch.data();
+
+    for (int pass = 0; pass < MORTON_PASSES; ++pass)
+    {
+        auto shift = pass * MORTON_RADIX_BITS;
+
+        chunks.Run([&](size_t c) {
+            auto h = histogram.data() + c * MORTON_RADIX;
+            memset(h, 0, MORTON_RADIX * sizeof(uint32_t));
+            for (size_t i = chunks.Begin(c); i < chunks.End(c); ++i)
+            {
+                h[(src_key[i] >> shift) & (MORTON_RADIX - 1)]++;
+            }
+        });
+
+        // Exclusive prefix over (digit, chunk), so each chunk scatters into
+        // its own run of each digit's range and the sort stays stable.
+        size_t offset = 0;
+        bool   skip   = false;
+        for (uint32_t d = 0; d < MORTON_RADIX && !skip; ++d)
+        {
+            auto start = offset;
+            for (size_t c = 0; c < chunks.count; ++c)
+            {
+                auto n                          = histogram[c * MORTON_RADIX + d];
+                histogram[c * MORTON_RADIX + d] = (uint32_t)offset;
+                offset += n;
+            }
+            // Every key has the same digit: this pass would be a copy.
+            skip = offset - start == count;
+        }
+        if (skip)
+        {
+            continue;
+        }
+
+        chunks.Run([&](size_t c) {
+            auto h = histogram.data() + c * MORTON_RADIX;
+            for (size_t i = chunks.Begin(c); i < chunks.End(c); ++i)
+            {
+                auto k        = src_key[i];
+                auto at       = h[(k >> shift) & (MORTON_RADIX - 1)]++;
+                dst_key[at]   = k;
+                dst_order[at] = src_order[i];
+            }
+        });
+
+        std::swap(src_key, dst_key);
+        std::swap(src_order, dst_order);
+    }
+
+    if (src_key != keys)
+    {
+        chunks.Run([&](size_t c) {
+            auto begin = chunks.Begin(c);
+            auto n     = chunks.End(c) - begin;
+            memcpy(keys + begin, src_key + begin, n * sizeof(uint32_t));
+            memcpy(order + begin, src_order + begin, n * sizeof(uint32_t));
+        });
+    }
+}
+
+
+void
+Morton_Reorder(VecSoA const& in, VecSoA const& out, uint32_t* order, uint32_t* keys, size_t count, int thread_count)
+{
+    std::vector<uint32_t> key_storage;
+    if (!keys)
+    {
+        key_storage.resize(count);
+        keys = key_storage.data();
+    }
+
+    Vec lo, hi;
+    Morton_Bounds(in, count, lo, hi, thread_count);
+    Morton_Keys(in, lo, hi, keys, count, thread_count);
+    Morton_Sort(keys, order, count, thread_count);
+
+    Morton_Gather(in.x, order, out.x, count, thread_count);
+    Morton_Gather(in.y, order, out.y, count, thread_count);
+    Morton_Gather(in.z, order, out.z, count, thread_count);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+
+// Morton (Z-order) reordering of Vec arrays.
+//
+// Points are quantised to a 1024^3 grid over a bounding box and their three
+// 10-bit coordinates interleaved into a 30-bit key. Sorting by key puts
+// points that are close in space close in memory, so batch kernels and
+// neighbour queries that visit nearby points touch far fewer cache lines and
+// pages.
+//
+// Reordering produces a permutation, order[i] = index in the input of the
+// element that lands at position i, so attributes stored in other arrays can
+// be moved the same way with Morton_Gather. Counts must fit in 32 bits.
+
+
+#define MORTON_BITS 10
+
+
+// Spreads the low 10 bits of v so bit i moves to bit 3i.
+inline uint32_t
+Morton_Spread(uint32_t v)
+{
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+
+// Key for grid coordinates; x in the lowest bit of each triple.
+inline uint32_t
+Morton_Encode(uint32_t x, uint32_t y, uint32_t z)
+{
+    return Morton_Spread(x) | (Morton_Spread(y) << 1) | (Morton_Spread(z) << 2);
+}
+
+
+// Bounding box of the points, used to scale them onto the grid.
+void
+Morton_Bounds(VecSoA const& in, size_t count, Vec& lo, Vec& hi, int thread_count = 0);
+
+
+// keys[i] = key of in[i] on the grid spanning [lo, hi]. Points outside the
+// box are clamped to its faces.
+void
+Morton_Keys(VecSoA const& in, Vec const& lo, Vec const& hi, uint32_t* keys, size_t count, int thread_count = 0);
+
+
+// Stable LSD radix sort of keys, in place. Writes the permutation to order.
+// The result does not depend on thread_count.
+void
+Morton_Sort(uint32_t* keys, uint32_t* order, size_t count, int thread_count = 0);
+
+
+// Computes bounds, keys and the sorted permutation, then reorders the
+// points. in and out may not alias. keys may be nullptr if not wanted.
+void
+Morton_Reorder(VecSoA const& in, VecSoA const& out, uint32_t* order, uint32_t* keys, size_t count, int thread_count = 0);
+
+
+// dst[i] = src[order[i]], for attributes that follow the points.
+template <typename T>
+void
+Morton_Gather(T const* src, uint32_t const* order, T* dst, size_t count, int thread_count = 0)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            dst[i] = src[order[i]];
+        }
+    });
+}
@@ -0,0 +1,177 @@
+#include "GeometricAlgebra/orientation_buffer.h"
+#include <assert.h>
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define ORIENTATION_CACHE_LINE 64
+
+// The published word packs the current buffer index into the low bits and
+// the number of readers that have acquired it into the rest, so a reader
+// takes a reference and learns which buffer it got in one fetch_add.
+#define ORIENTATION_INDEX_BITS 8
+#define ORIENTATION_INDEX_MASK ((1u << ORIENTATION_INDEX_BITS) - 1)
+#define ORIENTATION_READER     ((uint64_t)1 << ORIENTATION_INDEX_BITS)
+
+
+struct OrientationSlot
+{
+    // Readers bump this on release. Cumulative over the slot's lifetime.
+    alignas(ORIENTATION_CACHE_LINE) std::atomic<uint64_t> released;
+
+    // Read by readers, written by the writer before publishing.
+    alignas(ORIENTATION_CACHE_LINE) uint64_t version;
+    Rotor*   rotors;
+    Matrix4* matrices;
+
+    // Writer only: total acquisitions, added when the slot stops being the
+    // published one. The slot is free when released catches up.
+    alignas(ORIENTATION_CACHE_LINE) uint64_t acquired;
+};
+
+
+struct OrientationBuffer
+{
+    alignas(ORIENTATION_CACHE_LINE) std::atomic<uint64_t> published;
+
+    alignas(ORIENTATION_CACHE_LINE) OrientationSlot* slots;
+    int      slot_count;
+    size_t   count;
+    int      current; // Writer's copy of the published index.
+    int      next;    // Where the writer's search for a free slot starts.
+    uint64_t version;
+};
+
+
+static void*
+AllocLines(size_t bytes)
+{
+    bytes = (bytes + ORIENTATION_CACHE_LINE - 1) & ~(size_t)(ORIENTATION_CACHE_LINE - 1);
+    return aligned_alloc(ORIENTATION_CACHE_LINE, bytes > 0 ? bytes : ORIENTATION_CACHE_LINE);
+}
+
+
+OrientationBuffer*
+OrientationBuffer_Create(size_t count, int max_readers, bool with_matrices)
+{
+    assert(max_readers >= 1 && max_readers + 2 <= (int)ORIENTATION_INDEX_MASK + 1);
+
+    auto b        = new OrientationBuffer;
+    b->slot_count = max_readers + 2;
+    b->slots      = new OrientationSlot[b->slot_count];
+    b->count      = count;
+    b->current    = 0;
+    b->next       = 1;
+    b->version    = 0;
+
+    auto identity = ToMatrix4(Rotor());
+    for (int i = 0; i < b->slot_count; ++i)
+    {
+        auto& slot = b->slots[i];
+        slot.released.store(0, std::memory_order_relaxed);
+        slot.acquired = 0;
+        slot.version  = 0;
+        slot.rotors   = (Rotor*)AllocLines(count * sizeof(Rotor));
+        slot.matrices = with_matrices ? (Matrix4*)AllocLines(count * sizeof(Matrix4)) : nullptr;
+        for (size_t j = 0; j < count; ++j)
+        {
+            slot.rotors[j] = Rotor();
+            if (slot.matrices)
+            {
+                slot.matrices[j] = identity;
+            }
+        }
+    }
+
+    b->published.store(0, std::memory_order_release);
+    return b;
+}
+
+
+void
+OrientationBuffer_Destroy(OrientationBuffer* buffer)
+{
+    for (int i = 0; i < buffer->slot_count; ++i)
+    {
+        free(buffer->slots[i].rotors);
+        free(buffer->slots[i].matrices);
+    }
+    delete[] buffer->slots;
+    delete buffer;
+}
+
+
+OrientationFrame
+OrientationBuffer_BeginWrite(OrientationBuffer* buffer, bool copy_latest)
+{
+    OrientationFrame frame = { nullptr, nullptr, buffer->count, -1 };
+
+    for (int n = 0; n < buffer->slot_count; ++n)
+    {
+        auto i = (buffer->next + n) % buffer->slot_count;
+        if (i == buffer->current)
+        {
+            continue;
+        }
+
+        // Acquire pairs with the readers' release, so their reads of the old
+        // contents finish before we overwrite them.
+        auto& slot = buffer->slots[i];
+        if (slot.released.load(std::memory_order_acquire) != slot.acquired)
+        {
+            continue;
+        }
+
+        buffer->next   = (i + 1) % buffer->slot_count;
+        frame.rotors   = slot.rotors;
+        frame.matrices = slot.matrices;
+        frame.buffer   = i;
+
+        if (copy_latest)
+        {
+            auto const& latest = buffer->slots[buffer->current];
+            memcpy(slot.rotors, latest.rotors, buffer->count * sizeof(Rotor));
+            if (slot.matrices)
+            {
+                memcpy(slot.matrices, latest.matrices, buffer->count * sizeof(Matrix4));
+            }
+        }
+        break;
+    }
+
+    return frame;
+}
+
+
+void
+OrientationBuffer_Publish(OrientationBuffer* buffer, OrientationFrame const& frame)
+{
+    assert(frame.buffer >= 0 && frame.buffer < buffer->slot_count && frame.buffer != buffer->current);
+
+    buffer->slots[frame.buffer].version = ++buffer->version;
+
+    auto old = buffer->published.exchange((uint64_t)frame.buffer, std::memory_order_acq_rel);
+    auto i   = (int)(old & ORIENTATION_INDEX_MASK);
+
+    buffer->slots[i].acquired += old >> ORIENTATION_INDEX_BITS;
+    buffer->current = frame.buffer;
+}
+
+
+OrientationSnapshot
+OrientationBuffer_Acquire(OrientationBuffer* buffer)
+{
+    auto        word = buffer->published.fetch_add(ORIENTATION_READER, std::memory_order_acquire);
+    auto        i    = (int)(word & ORIENTATION_INDEX_MASK);
+    auto const& slot = buffer->slots[i];
+
+    return { slot.rotors, slot.matrices, buffer->count, slot.version, i };
+}
+
+
+void
+OrientationBuffer_Release(OrientationBuffer* buffer, OrientationSnapshot const& snapshot)
+{
+    buffer->slots[snapshot.buffer].released.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+
+// Multi-buffered Rotor (and optionally Matrix4) arrays shared between one
+// writer thread and several reader threads, without locks or copies.
+//
+// The writer fills a free buffer and publishes it; readers acquire whichever
+// buffer was published most recently and read it in place until they release
+// it. A buffer is only reused once every reader that acquired it has released
+// it, so a snapshot never changes while held.
+//
+// Acquire, Release and Publish are each a single atomic read-modify-write and
+// never wait. The buffer count is max_readers + 2, so as long as each reader
+// holds at most one snapshot at a time the writer always finds a free buffer
+// too. This is a triple buffer generalised to several readers; readers that
+// need the latest frame should release and re-acquire once per frame.
+
+
+struct OrientationBuffer;
+
+
+// What a reader sees. Valid until passed to OrientationBuffer_Release.
+struct OrientationSnapshot
+{
+    Rotor const*   rotors;
+    Matrix4 const* matrices; // nullptr unless created with matrices.
+    size_t         count;
+    uint64_t       version;  // 0 for the initial identity frame, then 1, 2, ...
+    int            buffer;
+};
+
+
+// What the writer fills before publishing.
+struct OrientationFrame
+{
+    Rotor*   rotors;   // nullptr if no buffer was free.
+    Matrix4* matrices;
+    size_t   count;
+    int      buffer;
+};
+
+
+// Every buffer starts out holding identity rotors (and matrices).
+// max_readers must be at most 254.
+OrientationBuffer*
+OrientationBuffer_Create(size_t count, int max_readers, bool with_matrices);
+
+
+// No snapshots may be held.
+void
+OrientationBuffer_Destroy(OrientationBuffer* buffer);
+
+
+// ---- Writer side; call from one thread only. ----
+
+// Returns a buffer no reader holds. Its contents are an older frame unless
+// copy_latest is set, in which case the latest published frame is copied in
+// first (for writers that only update some entries). Returns a frame with
+// null rotors if every buffer is held, which only happens when readers hold
+// more than one snapshot each.
+OrientationFrame
+OrientationBuffer_BeginWrite(OrientationBuffer* buffer, bool copy_latest = false);
+
+
+// Makes the frame the one readers acquire from now on.
+void
+OrientationBuffer_Publish(OrientationBuffer* buffer, OrientationFrame const& frame);
+
+
+// ---- Reader side; any number of threads, up to max_readers at once. ----
+
+OrientationSnapshot
+OrientationBuffer_Acquire(OrientationBuffer* buffer);
+
+
+void
+OrientationBuffer_Release(OrientationBuffer* buffer, OrientationSnapshot const& snapshot);
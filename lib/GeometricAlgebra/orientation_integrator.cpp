@@ -0,0 +1,227 @@
+#include "GeometricAlgebra/orientation_integrator.h"
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// Computes the half-angle exp coefficients for bivector b = -W dt / 2 with
+// theta = |b|: exp(b) = c + k * b.
+static inline void
+ExpCoefficients(IntegratorExp mode, float theta2, float& c, float& k)
+{
+    if (mode == IntegratorExp_Approximate)
+    {
+        c = 1.0f - theta2 * (1.0f / 2.0f) + theta2 * theta2 * (1.0f / 24.0f);
+        k = 1.0f - theta2 * (1.0f / 6.0f) + theta2 * theta2 * (1.0f / 120.0f);
+        return;
+    }
+
+    auto theta = sqrtf(theta2);
+    c          = cosf(theta);
+    k          = theta > 1e-6f ? sinf(theta) / theta : 1.0f;
+}
+
+
+static void
+StepScalar(IntegratorExp      mode,
+           bool               normalise,
+           RotorSoA const&    R,
+           BiVectorSoA const& W,
+           size_t             begin,
+           size_t             end,
+           float              half_dt)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto b12 = -W.e12[i] * half_dt;
+        auto b13 = -W.e13[i] * half_dt;
+        auto b23 = -W.e23[i] * half_dt;
+
+        float c, k;
+        ExpCoefficients(mode, b12 * b12 + b13 * b13 + b23 * b23, c, k);
+        b12 *= k;
+        b13 *= k;
+        b23 *= k;
+
+        auto qa  = R.s[i];
+        auto q12 = R.e12[i];
+        auto q13 = R.e13[i];
+        auto q23 = R.e23[i];
+
+        auto s   = c * qa - b12 * q12 - b13 * q13 - b23 * q23;
+        auto e12 = c * q12 + b12 * qa - b13 * q23 + b23 * q13;
+        auto e13 = c * q13 + b13 * qa + b12 * q23 - b23 * q12;
+        auto e23 = c * q23 + b23 * qa - b12 * q13 + b13 * q12;
+
+        if (normalise)
+        {
+            auto inv = 1.0f / sqrtf(s * s + e12 * e12 + e13 * e13 + e23 * e23);
+            s *= inv;
+            e12 *= inv;
+            e13 *= inv;
+            e23 *= inv;
+        }
+
+        R.s[i]   = s;
+        R.e12[i] = e12;
+        R.e13[i] = e13;
+        R.e23[i] = e23;
+    }
+}
+
+
+#if defined(__SSE2__)
+
+// sin and cos of four angles. Cody-Waite reduction by pi/2 followed by the
+// Cephes minimax polynomials on [-pi/4, pi/4]; max error is a few ulp for
+// |x| < 8192.
+static inline void
+SinCos4(__m128 x, __m128& sin_out, __m128& cos_out)
+{
+    auto j  = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977236f)));
+    auto jf = _mm_cvtepi32_ps(j);
+
+    auto r = _mm_sub_ps(x, _mm_mul_ps(jf, _mm_set1_ps(1.5703125f)));
+    r      = _mm_sub_ps(r, _mm_mul_ps(jf, _mm_set1_ps(4.837512969970703125e-4f)));
+    r      = _mm_sub_ps(r, _mm_mul_ps(jf, _mm_set1_ps(7.54978995489188216e-8f)));
+    auto r2 = _mm_mul_ps(r, r);
+
+    auto sp = _mm_set1_ps(-1.9515295891e-4f);
+    sp      = _mm_add_ps(_mm_mul_ps(sp, r2), _mm_set1_ps(8.3321608736e-3f));
+    sp      = _mm_add_ps(_mm_mul_ps(sp, r2), _mm_set1_ps(-1.6666654611e-1f));
+    sp      = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sp, r2), r), r);
+
+    auto cp = _mm_set1_ps(2.443315711809948e-5f);
+    cp      = _mm_add_ps(_mm_mul_ps(cp, r2), _mm_set1_ps(-1.388731625493765e-3f));
+    cp      = _mm_add_ps(_mm_mul_ps(cp, r2), _mm_set1_ps(4.166664568298827e-2f));
+    cp      = _mm_mul_ps(_mm_mul_ps(cp, r2), r2);
+    cp      = _mm_add_ps(_mm_sub_ps(cp, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    // Quadrant j: odd quadrants swap sin and cos, then signs follow j.
+    auto one  = _mm_set1_epi32(1);
+    auto two  = _mm_set1_epi32(2);
+    auto swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, one), one));
+
+    auto s = _mm_or_ps(_mm_and_ps(swap, cp), _mm_andnot_ps(swap, sp));
+    auto c = _mm_or_ps(_mm_and_ps(swap, sp), _mm_andnot_ps(swap, cp));
+
+    auto sin_sign = _mm_slli_epi32(_mm_and_si128(j, two), 30);
+    auto cos_sign = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, one), two), 30);
+
+    sin_out = _mm_xor_ps(s, _mm_castsi128_ps(sin_sign));
+    cos_out = _mm_xor_ps(c, _mm_castsi128_ps(cos_sign));
+}
+
+
+static void
+StepSSE(IntegratorExp      mode,
+        bool               normalise,
+        RotorSoA const&    R,
+        BiVectorSoA const& W,
+        size_t             begin,
+        size_t             end,
+        float              half_dt)
+{
+    auto const scale = _mm_set1_ps(-half_dt);
+    auto const one   = _mm_set1_ps(1.0f);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        auto b12 = _mm_mul_ps(_mm_loadu_ps(W.e12 + i), scale);
+        auto b13 = _mm_mul_ps(_mm_loadu_ps(W.e13 + i), scale);
+        auto b23 = _mm_mul_ps(_mm_loadu_ps(W.e23 + i), scale);
+
+        auto theta2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b12, b12), _mm_mul_ps(b13, b13)),
+                                 _mm_mul_ps(b23, b23));
+
+        __m128 c, k;
+        if (mode == IntegratorExp_Approximate)
+        {
+            auto t4 = _mm_mul_ps(theta2, theta2);
+            c = _mm_add_ps(_mm_sub_ps(one, _mm_mul_ps(theta2, _mm_set1_ps(1.0f / 2.0f))),
+                           _mm_mul_ps(t4, _mm_set1_ps(1.0f / 24.0f)));
+            k = _mm_add_ps(_mm_sub_ps(one, _mm_mul_ps(theta2, _mm_set1_ps(1.0f / 6.0f))),
+                           _mm_mul_ps(t4, _mm_set1_ps(1.0f / 120.0f)));
+        }
+        else
+        {
+            auto theta = _mm_sqrt_ps(theta2);
+            __m128 s;
+            SinCos4(theta, s, c);
+
+            // sin(theta) / theta, falling back to 1 near zero.
+            auto tiny = _mm_cmplt_ps(theta, _mm_set1_ps(1e-6f));
+            auto den  = _mm_or_ps(_mm_and_ps(tiny, one), _mm_andnot_ps(tiny, theta));
+            k = _mm_or_ps(_mm_and_ps(tiny, one), _mm_andnot_ps(tiny, _mm_div_ps(s, den)));
+        }
+
+        b12 = _mm_mul_ps(b12, k);
+        b13 = _mm_mul_ps(b13, k);
+        b23 = _mm_mul_ps(b23, k);
+
+        auto qa  = _mm_loadu_ps(R.s + i);
+        auto q12 = _mm_loadu_ps(R.e12 + i);
+        auto q13 = _mm_loadu_ps(R.e13 + i);
+        auto q23 = _mm_loadu_ps(R.e23 + i);
+
+        auto s = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(c, qa), _mm_mul_ps(b12, q12)),
+                                       _mm_mul_ps(b13, q13)),
+                            _mm_mul_ps(b23, q23));
+        auto e12 = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(c, q12), _mm_mul_ps(b12, qa)),
+                                         _mm_mul_ps(b13, q23)),
+                              _mm_mul_ps(b23, q13));
+        auto e13 = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c, q13), _mm_mul_ps(b13, qa)),
+                                         _mm_mul_ps(b12, q23)),
+                              _mm_mul_ps(b23, q12));
+        auto e23 = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(c, q23), _mm_mul_ps(b23, qa)),
+                                         _mm_mul_ps(b12, q13)),
+                              _mm_mul_ps(b13, q12));
+
+        if (normalise)
+        {
+            auto l2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(s, s), _mm_mul_ps(e12, e12)),
+                                 _mm_add_ps(_mm_mul_ps(e13, e13), _mm_mul_ps(e23, e23)));
+            auto inv = _mm_div_ps(one, _mm_sqrt_ps(l2));
+            s   = _mm_mul_ps(s, inv);
+            e12 = _mm_mul_ps(e12, inv);
+            e13 = _mm_mul_ps(e13, inv);
+            e23 = _mm_mul_ps(e23, inv);
+        }
+
+        _mm_storeu_ps(R.s + i, s);
+        _mm_storeu_ps(R.e12 + i, e12);
+        _mm_storeu_ps(R.e13 + i, e13);
+        _mm_storeu_ps(R.e23 + i, e23);
+    }
+
+    StepScalar(mode, normalise, R, W, i, end, half_dt);
+}
+
+#endif
+
+
+void
+Integrator_Step(OrientationIntegrator& integrator,
+                RotorSoA const&        R,
+                BiVectorSoA const&     W,
+                size_t                 count,
+                float                  dt)
+{
+    auto mode      = integrator.exp;
+    auto every     = integrator.normalise_every;
+    bool normalise = every > 0 && (integrator.step + 1) % (uint64_t)every == 0;
+    auto half_dt   = 0.5f * dt;
+
+    Batch_ParallelFor(count, 4096, integrator.thread_count, [&](size_t begin, size_t end) {
+#if defined(__SSE2__)
+        StepSSE(mode, normalise, R, W, begin, end, half_dt);
+#else
+        StepScalar(mode, normalise, R, W, begin, end, half_dt);
+#endif
+    });
+
+    integrator.step++;
+}
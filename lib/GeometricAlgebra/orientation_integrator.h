@@ -0,0 +1,54 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include <cstddef>
+#include <stdint.h>
+
+// Batch integration of rigid-body orientations.
+//
+// Each step applies R <- exp(-W dt / 2) R, where W is the angular velocity
+// bivector in world space. For W = w e12 and w > 0 this turns e1 towards e2,
+// matching Vec_Rotate(R, v). The composition uses the Cl(3,0) geometric
+// product, so Vec_Rotate(R_new, v) == Vec_Rotate(exp(-W dt / 2), Vec_Rotate(R_old, v)).
+
+
+enum IntegratorExp
+{
+    // exp computed with sin/cos. Exact for any step size.
+    IntegratorExp_Exact,
+
+    // exp replaced by its Taylor series to the 4th/5th order terms. Cheaper,
+    // and accurate while |W| dt stays well below one radian.
+    IntegratorExp_Approximate,
+};
+
+
+struct OrientationIntegrator
+{
+    IntegratorExp exp;
+
+    // Renormalise the rotors every N steps. 0 disables renormalisation,
+    // 1 renormalises on every step.
+    int normalise_every;
+
+    // Worker threads per step. 0 uses one per hardware thread.
+    int thread_count;
+
+    // Number of steps taken so far. Drives the renormalisation cadence.
+    uint64_t step;
+};
+
+
+inline OrientationIntegrator
+Integrator_Create(IntegratorExp exp = IntegratorExp_Exact, int normalise_every = 16)
+{
+    return { exp, normalise_every, 0, 0 };
+}
+
+
+// Advances `count` orientations by one timestep dt. R is updated in place.
+void
+Integrator_Step(OrientationIntegrator& integrator,
+                RotorSoA const&        R,
+                BiVectorSoA const&     W,
+                size_t                 count,
+                float                  dt);
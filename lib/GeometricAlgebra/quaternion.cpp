@@ -0,0 +1,85 @@
+#include "GeometricAlgebra/quaternion.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// Rotor is four contiguous floats, which the SIMD path and in-place
+// aliasing both rely on.
+static_assert(sizeof(Rotor) == 4 * sizeof(float), "Rotor must be packed");
+
+
+// out[j] = sign[j] * in[I_j] for each group of 4 floats. The permutation is
+// a template argument so it becomes the shuffle immediate.
+template <int I0, int I1, int I2, int I3>
+static void
+Convert(float const* in, float* out, size_t count, float const (&sign)[4], int thread_count)
+{
+    Batch_ParallelFor(count, 4096, thread_count, [&](size_t begin, size_t end) {
+        size_t i = begin;
+
+#if defined(__SSE2__)
+        // Sign flips as an xor with -0.0 in the flipped lanes.
+        auto mask = _mm_and_ps(_mm_setr_ps(sign[0], sign[1], sign[2], sign[3]), _mm_set1_ps(-0.0f));
+
+        // Two per iteration; both are loaded before either is stored, so
+        // in == out is fine.
+        for (; i + 2 <= end; i += 2)
+        {
+            auto a = _mm_loadu_ps(in + 4 * i);
+            auto b = _mm_loadu_ps(in + 4 * i + 4);
+            a      = _mm_shuffle_ps(a, a, _MM_SHUFFLE(I3, I2, I1, I0));
+            b      = _mm_shuffle_ps(b, b, _MM_SHUFFLE(I3, I2, I1, I0));
+            _mm_storeu_ps(out + 4 * i, _mm_xor_ps(a, mask));
+            _mm_storeu_ps(out + 4 * i + 4, _mm_xor_ps(b, mask));
+        }
+#endif
+
+        for (; i < end; ++i)
+        {
+            float v[4] = { in[4 * i + I0], in[4 * i + I1], in[4 * i + I2], in[4 * i + I3] };
+            for (int j = 0; j < 4; ++j)
+            {
+                out[4 * i + j] = sign[j] * v[j];
+            }
+        }
+    });
+}
+
+
+//  Rotor (s, e12, e13, e23) <-> (w, x, y, z) = (s, -e23, e13, -e12), either way.
+static float const wxyz_sign[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+
+//  Rotor -> (x, y, z, w) = (-e23, e13, -e12, s)
+//  (x, y, z, w) -> Rotor = (w, -z, y, -x)
+static float const to_xyzw_sign[4]   = { -1.0f, 1.0f, -1.0f, 1.0f };
+static float const from_xyzw_sign[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+
+
+void
+Quat_FromRotors(Rotor const* in, float* out, size_t count, QuatLayout layout, int thread_count)
+{
+    if (layout == QuatLayout_WXYZ)
+    {
+        Convert<0, 3, 2, 1>(&in->s, out, count, wxyz_sign, thread_count);
+    }
+    else
+    {
+        Convert<3, 2, 1, 0>(&in->s, out, count, to_xyzw_sign, thread_count);
+    }
+}
+
+
+void
+Quat_ToRotors(float const* in, Rotor* out, size_t count, QuatLayout layout, int thread_count)
+{
+    if (layout == QuatLayout_WXYZ)
+    {
+        Convert<0, 3, 2, 1>(in, &out->s, count, wxyz_sign, thread_count);
+    }
+    else
+    {
+        Convert<3, 2, 1, 0>(in, &out->s, count, from_xyzw_sign, thread_count);
+    }
+}
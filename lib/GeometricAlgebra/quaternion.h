@@ -0,0 +1,150 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+
+// Quaternion interop for Rotor arrays.
+//
+// A unit quaternion w + xi + yj + zk, rotating by v' = q v q* (Hamilton
+// convention, as used by most physics and rendering libraries), is the rotor
+//
+//   s = w,  e12 = -z,  e13 = y,  e23 = -x
+//
+// so Vec_Rotate(Rotor_FromQuat(q), v) == q v q*. Rotor stores (s, e12, e13,
+// e23); converting to either common quaternion layout is a permutation plus
+// two sign flips.
+//
+// QuatView presents a Rotor array as quaternions without copying, doing the
+// permutation and signs on each access. Where a library needs the memory
+// itself in quaternion layout, Quat_FromRotors and Quat_ToRotors convert
+// whole arrays with SIMD, in place if wanted.
+
+
+enum QuatLayout
+{
+    QuatLayout_WXYZ, // Eigen's coefficient constructor, glm's constructor.
+    QuatLayout_XYZW  // Eigen's storage, PhysX, Bullet, Unity, DirectXMath.
+};
+
+
+struct Quat
+{
+    float w;
+    float x;
+    float y;
+    float z;
+};
+
+
+inline Quat
+Quat_FromRotor(Rotor const& R)
+{
+    return { R.s, -R.B.e23, R.B.e13, -R.B.e12 };
+}
+
+
+inline Rotor
+Rotor_FromQuat(Quat const& q)
+{
+    return Rotor(q.w, -q.z, q.y, -q.x);
+}
+
+
+// Strided view of Rotors as quaternions. The Rotors need not be contiguous:
+// stride is the distance in bytes between consecutive ones, so a view can
+// run over the Rotor member of an array of structs. Reads and writes go
+// straight to the Rotors.
+//
+// operator()(i, k) gives component k of quaternion i in layout L, so code
+// written against raw wxyz or xyzw float[4] arrays can index the view the
+// same way.
+template <QuatLayout L>
+struct QuatView
+{
+    uint8_t* base;
+    size_t   stride;
+    size_t   count;
+
+    QuatView(Rotor* rotors, size_t count, size_t stride = sizeof(Rotor))
+        : base((uint8_t*)rotors), stride(stride), count(count)
+    {
+    }
+
+    Rotor&
+    At(size_t i) const
+    {
+        return *(Rotor*)(this->base + i * this->stride);
+    }
+
+    Quat
+    Get(size_t i) const
+    {
+        return Quat_FromRotor(this->At(i));
+    }
+
+    void
+    Set(size_t i, Quat const& q) const
+    {
+        this->At(i) = Rotor_FromQuat(q);
+    }
+
+    float
+    W(size_t i) const
+    {
+        return this->At(i).s;
+    }
+
+    float
+    X(size_t i) const
+    {
+        return -this->At(i).B.e23;
+    }
+
+    float
+    Y(size_t i) const
+    {
+        return this->At(i).B.e13;
+    }
+
+    float
+    Z(size_t i) const
+    {
+        return -this->At(i).B.e12;
+    }
+
+    float
+    operator()(size_t i, int k) const
+    {
+        if (L == QuatLayout_XYZW)
+        {
+            k = (k + 1) & 3; // x y z w -> w x y z order
+        }
+        switch (k)
+        {
+        case 0:
+            return this->W(i);
+        case 1:
+            return this->X(i);
+        case 2:
+            return this->Y(i);
+        default:
+            return this->Z(i);
+        }
+    }
+};
+
+
+typedef QuatView<QuatLayout_WXYZ> QuatViewWXYZ;
+typedef QuatView<QuatLayout_XYZW> QuatViewXYZW;
+
+
+// Converts count Rotors into packed quaternions (4 floats each) in the
+// given layout. out may be the same memory as in, for in-place conversion.
+void
+Quat_FromRotors(Rotor const* in, float* out, size_t count, QuatLayout layout, int thread_count = 0);
+
+
+// Inverse of Quat_FromRotors. out may be the same memory as in.
+void
+Quat_ToRotors(float const* in, Rotor* out, size_t count, QuatLayout layout, int thread_count = 0);
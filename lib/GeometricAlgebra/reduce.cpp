@@ -0,0 +1,354 @@
+#include "GeometricAlgebra/reduce.h"
+#include "GeometricAlgebra/rotation3.h"
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// Sums are of p - shift, where shift is the first point, so the covariance
+// does not cancel catastrophically for points far from the origin.
+struct Partial
+{
+    float sum[3];
+    float sum2[6]; // xx, xy, xz, yy, yz, zz
+    float lo[3];
+    float hi[3];
+};
+
+
+#if defined(__SSE2__)
+
+static inline float
+HorizontalSum(__m128 v)
+{
+    float lane[4];
+    _mm_storeu_ps(lane, v);
+    return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+}
+
+
+static inline float
+HorizontalMin(__m128 v)
+{
+    float lane[4];
+    _mm_storeu_ps(lane, v);
+    auto a = lane[0] < lane[1] ? lane[0] : lane[1];
+    auto b = lane[2] < lane[3] ? lane[2] : lane[3];
+    return a < b ? a : b;
+}
+
+
+static inline float
+HorizontalMax(__m128 v)
+{
+    float lane[4];
+    _mm_storeu_ps(lane, v);
+    auto a = lane[0] > lane[1] ? lane[0] : lane[1];
+    auto b = lane[2] > lane[3] ? lane[2] : lane[3];
+    return a > b ? a : b;
+}
+
+#endif
+
+
+// One block. Templated on what to compute so each combination gets its own
+// loop with no per-point branches.
+template <bool SUMS, bool BOUNDS, bool COVARIANCE>
+static Partial
+ReduceBlock(VecSoA const& in, size_t begin, size_t end, Vec const& shift)
+{
+    Partial p = {};
+    p.lo[0] = p.hi[0] = in.x[begin];
+    p.lo[1] = p.hi[1] = in.y[begin];
+    p.lo[2] = p.hi[2] = in.z[begin];
+
+    size_t i = begin;
+
+#if defined(__SSE2__)
+    auto zero = _mm_setzero_ps();
+    auto kx = _mm_set1_ps(shift.x), ky = _mm_set1_ps(shift.y), kz = _mm_set1_ps(shift.z);
+    auto sx = zero, sy = zero, sz = zero;
+    auto sxx = zero, sxy = zero, sxz = zero, syy = zero, syz = zero, szz = zero;
+    auto lx = _mm_set1_ps(p.lo[0]), ly = _mm_set1_ps(p.lo[1]), lz = _mm_set1_ps(p.lo[2]);
+    auto hx = lx, hy = ly, hz = lz;
+
+    for (; i + 4 <= end; i += 4)
+    {
+        auto x = _mm_loadu_ps(in.x + i);
+        auto y = _mm_loadu_ps(in.y + i);
+        auto z = _mm_loadu_ps(in.z + i);
+
+        if (BOUNDS)
+        {
+            lx = _mm_min_ps(lx, x);
+            ly = _mm_min_ps(ly, y);
+            lz = _mm_min_ps(lz, z);
+            hx = _mm_max_ps(hx, x);
+            hy = _mm_max_ps(hy, y);
+            hz = _mm_max_ps(hz, z);
+        }
+        if (SUMS)
+        {
+            x  = _mm_sub_ps(x, kx);
+            y  = _mm_sub_ps(y, ky);
+            z  = _mm_sub_ps(z, kz);
+            sx = _mm_add_ps(sx, x);
+            sy = _mm_add_ps(sy, y);
+            sz = _mm_add_ps(sz, z);
+        }
+        if (COVARIANCE)
+        {
+            sxx = _mm_add_ps(sxx, _mm_mul_ps(x, x));
+            sxy = _mm_add_ps(sxy, _mm_mul_ps(x, y));
+            sxz = _mm_add_ps(sxz, _mm_mul_ps(x, z));
+            syy = _mm_add_ps(syy, _mm_mul_ps(y, y));
+            syz = _mm_add_ps(syz, _mm_mul_ps(y, z));
+            szz = _mm_add_ps(szz, _mm_mul_ps(z, z));
+        }
+    }
+
+    p.sum[0]  = HorizontalSum(sx);
+    p.sum[1]  = HorizontalSum(sy);
+    p.sum[2]  = HorizontalSum(sz);
+    p.sum2[0] = HorizontalSum(sxx);
+    p.sum2[1] = HorizontalSum(sxy);
+    p.sum2[2] = HorizontalSum(sxz);
+    p.sum2[3] = HorizontalSum(syy);
+    p.sum2[4] = HorizontalSum(syz);
+    p.sum2[5] = HorizontalSum(szz);
+    p.lo[0]   = HorizontalMin(lx);
+    p.lo[1]   = HorizontalMin(ly);
+    p.lo[2]   = HorizontalMin(lz);
+    p.hi[0]   = HorizontalMax(hx);
+    p.hi[1]   = HorizontalMax(hy);
+    p.hi[2]   = HorizontalMax(hz);
+#endif
+
+    for (; i < end; ++i)
+    {
+        float v[3] = { in.x[i], in.y[i], in.z[i] };
+        if (BOUNDS)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                p.lo[k] = v[k] < p.lo[k] ? v[k] : p.lo[k];
+                p.hi[k] = v[k] > p.hi[k] ? v[k] : p.hi[k];
+            }
+        }
+        if (SUMS)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                v[k] -= shift[k];
+                p.sum[k] += v[k];
+            }
+        }
+        if (COVARIANCE)
+        {
+            p.sum2[0] += v[0] * v[0];
+            p.sum2[1] += v[0] * v[1];
+            p.sum2[2] += v[0] * v[2];
+            p.sum2[3] += v[1] * v[1];
+            p.sum2[4] += v[1] * v[2];
+            p.sum2[5] += v[2] * v[2];
+        }
+    }
+
+    return p;
+}
+
+
+typedef Partial (*ReduceBlockFn)(VecSoA const&, size_t, size_t, Vec const&);
+
+
+static ReduceBlockFn
+SelectBlock(int flags)
+{
+    bool covariance = flags & Reduce_Covariance;
+    bool sums       = covariance || (flags & Reduce_Centroid);
+    bool bounds     = flags & Reduce_Bounds;
+
+    if (covariance)
+    {
+        return bounds ? ReduceBlock<true, true, true> : ReduceBlock<true, false, true>;
+    }
+    if (sums)
+    {
+        return bounds ? ReduceBlock<true, true, false> : ReduceBlock<true, false, false>;
+    }
+    return ReduceBlock<false, true, false>;
+}
+
+
+VecStats
+Reduce_Stats(VecSoA const& in, size_t count, int flags, int thread_count)
+{
+    VecStats stats = {};
+    stats.count    = count;
+    if (count == 0)
+    {
+        return stats;
+    }
+
+    auto block  = SelectBlock(flags);
+    Vec  shift  = { in.x[0], in.y[0], in.z[0] };
+    auto blocks = (count + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+
+    std::vector<Partial> partials(blocks);
+    Batch_ParallelFor(blocks, 1, thread_count, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            auto first  = b * REDUCE_BLOCK;
+            auto last   = first + REDUCE_BLOCK < count ? first + REDUCE_BLOCK : count;
+            partials[b] = block(in, first, last, shift);
+        }
+    });
+
+    // Combine in block order, independent of how blocks were split.
+    double sum[3]  = {};
+    double sum2[6] = {};
+    auto   lo      = shift;
+    auto   hi      = shift;
+    for (auto const& p : partials)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            sum[k] += p.sum[k];
+            lo[k] = p.lo[k] < lo[k] ? p.lo[k] : lo[k];
+            hi[k] = p.hi[k] > hi[k] ? p.hi[k] : hi[k];
+        }
+        for (int k = 0; k < 6; ++k)
+        {
+            sum2[k] += p.sum2[k];
+        }
+    }
+
+    double n       = (double)count;
+    double mean[3] = { sum[0] / n, sum[1] / n, sum[2] / n };
+
+    if (flags & (Reduce_Centroid | Reduce_Covariance))
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            stats.centroid[k] = (float)(shift[k] + mean[k]);
+        }
+    }
+    if (flags & Reduce_Bounds)
+    {
+        stats.lo = lo;
+        stats.hi = hi;
+    }
+    if (flags & Reduce_Covariance)
+    {
+        int const row[6] = { 0, 0, 0, 1, 1, 2 };
+        int const col[6] = { 0, 1, 2, 1, 2, 2 };
+        for (int k = 0; k < 6; ++k)
+        {
+            stats.covariance[k] = (float)(sum2[k] / n - mean[row[k]] * mean[col[k]]);
+        }
+    }
+
+    return stats;
+}
+
+
+void
+Reduce_RotatedBox(Rotor const& R, Vec const& lo, Vec const& hi, Vec& out_lo, Vec& out_hi)
+{
+    Vec c, e;
+    Rotation3_Box(Rotation3_FromRotor(R), (lo + hi) * 0.5f, (hi - lo) * 0.5f, c, e);
+    out_lo = c - e;
+    out_hi = c + e;
+}
+
+
+void
+Reduce_RotatedBounds(Rotor const& R, VecSoA const& in, size_t count, Vec& lo, Vec& hi, int thread_count)
+{
+    if (count == 0)
+    {
+        lo = Vec_Zero();
+        hi = Vec_Zero();
+        return;
+    }
+
+    auto const  rotation = Rotation3_FromRotor(R);
+    auto const& Q        = rotation.m;
+
+    auto blocks = (count + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+
+    std::vector<Partial> partials(blocks);
+    Batch_ParallelFor(blocks, 1, thread_count, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            auto first = b * REDUCE_BLOCK;
+            auto last  = first + REDUCE_BLOCK < count ? first + REDUCE_BLOCK : count;
+            auto& p    = partials[b];
+
+            for (int k = 0; k < 3; ++k)
+            {
+                p.lo[k] = p.hi[k] = Q[k][0] * in.x[first] + Q[k][1] * in.y[first] + Q[k][2] * in.z[first];
+            }
+
+            size_t i = first;
+
+#if defined(__SSE2__)
+            __m128 q[3][3], l[3], h[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    q[k][j] = _mm_set1_ps(Q[k][j]);
+                }
+                l[k] = _mm_set1_ps(p.lo[k]);
+                h[k] = l[k];
+            }
+
+            for (; i + 4 <= last; i += 4)
+            {
+                auto x = _mm_loadu_ps(in.x + i);
+                auto y = _mm_loadu_ps(in.y + i);
+                auto z = _mm_loadu_ps(in.z + i);
+                for (int k = 0; k < 3; ++k)
+                {
+                    auto d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q[k][0], x), _mm_mul_ps(q[k][1], y)), _mm_mul_ps(q[k][2], z));
+                    l[k]   = _mm_min_ps(l[k], d);
+                    h[k]   = _mm_max_ps(h[k], d);
+                }
+            }
+
+            for (int k = 0; k < 3; ++k)
+            {
+                p.lo[k] = HorizontalMin(l[k]);
+                p.hi[k] = HorizontalMax(h[k]);
+            }
+#endif
+
+            for (; i < last; ++i)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    auto d  = Q[k][0] * in.x[i] + Q[k][1] * in.y[i] + Q[k][2] * in.z[i];
+                    p.lo[k] = d < p.lo[k] ? d : p.lo[k];
+                    p.hi[k] = d > p.hi[k] ? d : p.hi[k];
+                }
+            }
+        }
+    });
+
+    for (int k = 0; k < 3; ++k)
+    {
+        lo[k] = partials[0].lo[k];
+        hi[k] = partials[0].hi[k];
+    }
+    for (auto const& p : partials)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            lo[k] = p.lo[k] < lo[k] ? p.lo[k] : lo[k];
+            hi[k] = p.hi[k] > hi[k] ? p.hi[k] : hi[k];
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+
+// Single-pass statistics over Vec arrays.
+//
+// Reduce_Stats computes any combination of centroid, bounds and covariance
+// in one read of the points. The array is summed in fixed blocks of
+// REDUCE_BLOCK points, each with a fixed SIMD lane order, and the block
+// partials are combined in block order in double precision. Blocks are
+// spread over threads, but the summation order depends only on count, so
+// results are bit-identical for any thread_count.
+
+
+#define REDUCE_BLOCK 4096
+
+
+enum ReduceFlags
+{
+    Reduce_Centroid   = 1 << 0,
+    Reduce_Bounds     = 1 << 1,
+    Reduce_Covariance = 1 << 2, // Implies Reduce_Centroid.
+
+    Reduce_All = Reduce_Centroid | Reduce_Bounds | Reduce_Covariance
+};
+
+
+struct VecStats
+{
+    size_t count;
+    Vec    centroid;
+    Vec    lo;
+    Vec    hi;
+
+    // Population covariance (divided by count), symmetric:
+    // xx, xy, xz, yy, yz, zz.
+    float covariance[6];
+};
+
+
+// Fields not asked for by flags are left zero. With count == 0 everything
+// is zero.
+VecStats
+Reduce_Stats(VecSoA const& in, size_t count, int flags = Reduce_All, int thread_count = 0);
+
+
+// Bounds of the box [lo, hi] after rotating it by R about the origin. This
+// is a conservative bound: it contains every rotated point without touching
+// them, and is exact for the box's own corners, but can be arbitrarily
+// looser than the points' rotated bounds. Use Reduce_RotatedBounds when
+// tight bounds are needed.
+void
+Reduce_RotatedBox(Rotor const& R, Vec const& lo, Vec const& hi, Vec& out_lo, Vec& out_hi);
+
+
+// Exact bounds of Vec_Rotate(R, in[i]) over all points. Each point is
+// rotated by R's 3x3 matrix in registers and only the per-axis extremes are
+// kept, so the rotated points are never stored. This still costs a matrix
+// multiply per point; use Reduce_RotatedBox when a looser bound will do.
+void
+Reduce_RotatedBounds(Rotor const& R, VecSoA const& in, size_t count, Vec& lo, Vec& hi, int thread_count = 0);
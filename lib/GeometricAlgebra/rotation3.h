@@ -0,0 +1,54 @@
+#pragma once
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <math.h>
+
+// Internal: a rotor as a 3x3 row-major rotation matrix, for kernels that
+// apply one rotation to many points. Shared by compact_vec.cpp and
+// reduce.cpp; not part of the public API.
+
+
+// Vec_Rotate(R, v)[k] = dot(m[k], v).
+struct Rotation3
+{
+    float m[3][3];
+};
+
+
+inline Rotation3
+Rotation3_FromRotor(Rotor const& R)
+{
+    // ToMatrix4 stores the rotated basis vectors as columns: m[4 * i + k]
+    // is component k of R e_i.
+    auto      M = ToMatrix4(R);
+    Rotation3 Q;
+    for (int k = 0; k < 3; ++k)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            Q.m[k][i] = M[4 * i + k];
+        }
+    }
+    return Q;
+}
+
+
+inline Vec
+Rotation3_Apply(Rotation3 const& Q, Vec const& v)
+{
+    return { Q.m[0][0] * v.x + Q.m[0][1] * v.y + Q.m[0][2] * v.z,
+             Q.m[1][0] * v.x + Q.m[1][1] * v.y + Q.m[1][2] * v.z,
+             Q.m[2][0] * v.x + Q.m[2][1] * v.y + Q.m[2][2] * v.z };
+}
+
+
+// Tight bounds of the box of half-extent e about c after rotation: centre
+// Q c, half-extent |Q| e.
+inline void
+Rotation3_Box(Rotation3 const& Q, Vec const& c, Vec const& e, Vec& out_c, Vec& out_e)
+{
+    out_c = Rotation3_Apply(Q, c);
+    for (int k = 0; k < 3; ++k)
+    {
+        out_e[k] = fabsf(Q.m[k][0]) * e.x + fabsf(Q.m[k][1]) * e.y + fabsf(Q.m[k][2]) * e.z;
+    }
+}
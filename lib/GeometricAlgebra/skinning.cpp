@@ -0,0 +1,336 @@
+#include "GeometricAlgebra/skinning.h"
+#include <cassert>
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+
+
+void
+Skin_PrepareMatrices(SkinBone const* bones, size_t bone_count, SkinMatrix* out)
+{
+    for (size_t b = 0; b < bone_count; ++b)
+    {
+        // ToMatrix4 stores rotated basis vectors; transpose into rows.
+        auto M = ToMatrix4(bones[b].R);
+        for (int r = 0; r < 3; ++r)
+        {
+            out[b].m[4 * r + 0] = M[r];
+            out[b].m[4 * r + 1] = M[4 + r];
+            out[b].m[4 * r + 2] = M[8 + r];
+            out[b].m[4 * r + 3] = bones[b].t[r];
+        }
+    }
+}
+
+
+static void
+LinearScalar(SkinMatrix const* matrices, VecSoA const& in, SkinInfluences const& inf, VecSoA const& out, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto px = in.x[i];
+        auto py = in.y[i];
+        auto pz = in.z[i];
+
+        float x = 0, y = 0, z = 0;
+        for (int k = 0; k < inf.per_vertex; ++k)
+        {
+            auto  w = inf.weight[i * inf.per_vertex + k];
+            auto& m = matrices[inf.bone[i * inf.per_vertex + k]].m;
+            x += w * (m[0] * px + m[1] * py + m[2] * pz + m[3]);
+            y += w * (m[4] * px + m[5] * py + m[6] * pz + m[7]);
+            z += w * (m[8] * px + m[9] * py + m[10] * pz + m[11]);
+        }
+
+        out.x[i] = x;
+        out.y[i] = y;
+        out.z[i] = z;
+    }
+}
+
+
+// A bone as a motor: the rotor R and its dual part D = 1/2 t R, which is a
+// vector plus a trivector. Blending motors (dual quaternions) keeps each
+// bone's translation tied to its rotation, so a vertex at a bone's pivot
+// stays put whatever the other weights.
+struct Motor
+{
+    Rotor R;
+    float d1, d2, d3, d123;
+};
+
+
+static inline void
+DualPart(Rotor const& R, Vec const& t, float& d1, float& d2, float& d3, float& d123)
+{
+    d1   = 0.5f * (t.x * R.s - t.y * R.B.e12 - t.z * R.B.e13);
+    d2   = 0.5f * (t.y * R.s + t.x * R.B.e12 - t.z * R.B.e23);
+    d3   = 0.5f * (t.z * R.s + t.x * R.B.e13 + t.y * R.B.e23);
+    d123 = 0.5f * (t.x * R.B.e23 - t.y * R.B.e13 + t.z * R.B.e12);
+}
+
+
+// t = 2 <D ~R>_1 / |R|^2, valid for an unnormalised blend.
+static inline Vec
+Translation(Motor const& M, float l2)
+{
+    auto const& R = M.R;
+    auto        k = 2.0f / l2;
+    return { k * (M.d1 * R.s + M.d2 * R.B.e12 + M.d3 * R.B.e13 + M.d123 * R.B.e23),
+             k * (M.d2 * R.s - M.d1 * R.B.e12 + M.d3 * R.B.e23 - M.d123 * R.B.e13),
+             k * (M.d3 * R.s - M.d1 * R.B.e13 - M.d2 * R.B.e23 + M.d123 * R.B.e12) };
+}
+
+
+static void
+RotorScalar(SkinBone const* bones, VecSoA const& in, SkinInfluences const& inf, VecSoA const& out, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        auto const* bone   = inf.bone + i * inf.per_vertex;
+        auto const* weight = inf.weight + i * inf.per_vertex;
+        auto const& R0     = bones[bone[0]].R;
+
+        Motor M = { Rotor(0, 0, 0, 0), 0, 0, 0, 0 };
+        for (int k = 0; k < inf.per_vertex; ++k)
+        {
+            auto const& Rk = bones[bone[k]].R;
+            auto        w  = weight[k];
+
+            float d1, d2, d3, d123;
+            DualPart(Rk, bones[bone[k]].t, d1, d2, d3, d123);
+
+            auto d = R0.s * Rk.s + R0.B.e12 * Rk.B.e12 + R0.B.e13 * Rk.B.e13 + R0.B.e23 * Rk.B.e23;
+            w      = d < 0.0f ? -w : w;
+            M.R.s += w * Rk.s;
+            M.R.B.e12 += w * Rk.B.e12;
+            M.R.B.e13 += w * Rk.B.e13;
+            M.R.B.e23 += w * Rk.B.e23;
+            M.d1 += w * d1;
+            M.d2 += w * d2;
+            M.d3 += w * d3;
+            M.d123 += w * d123;
+        }
+
+        auto l2 = M.R.s * M.R.s + M.R.B.e12 * M.R.B.e12 + M.R.B.e13 * M.R.B.e13 + M.R.B.e23 * M.R.B.e23;
+        auto t  = Translation(M, l2);
+        auto R  = M.R;
+        Geo_Normalise(R);
+
+        auto p   = Vec_Rotate(R, { in.x[i], in.y[i], in.z[i] }) + t;
+        out.x[i] = p.x;
+        out.y[i] = p.y;
+        out.z[i] = p.z;
+    }
+}
+
+
+#if defined(__SSE2__)
+
+// Loads the 4 floats at base + b[j] * stride for each lane j and transposes
+// them, so out[c] holds float c of every lane's row.
+static inline void
+GatherTranspose(float const* base, size_t stride, uint16_t const b[4], __m128 out[4])
+{
+    out[0] = _mm_loadu_ps(base + b[0] * stride);
+    out[1] = _mm_loadu_ps(base + b[1] * stride);
+    out[2] = _mm_loadu_ps(base + b[2] * stride);
+    out[3] = _mm_loadu_ps(base + b[3] * stride);
+    _MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+}
+
+
+static void
+LinearSSE(SkinMatrix const* matrices, VecSoA const& in, SkinInfluences const& inf, VecSoA const& out, size_t begin, size_t end)
+{
+    auto const K      = inf.per_vertex;
+    auto const stride = sizeof(SkinMatrix) / sizeof(float);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        auto px = _mm_loadu_ps(in.x + i);
+        auto py = _mm_loadu_ps(in.y + i);
+        auto pz = _mm_loadu_ps(in.z + i);
+
+        auto x = _mm_setzero_ps();
+        auto y = _mm_setzero_ps();
+        auto z = _mm_setzero_ps();
+
+        for (int k = 0; k < K; ++k)
+        {
+            uint16_t b[4] = { inf.bone[(i + 0) * K + k], inf.bone[(i + 1) * K + k],
+                              inf.bone[(i + 2) * K + k], inf.bone[(i + 3) * K + k] };
+            auto     w    = _mm_setr_ps(inf.weight[(i + 0) * K + k], inf.weight[(i + 1) * K + k],
+                                        inf.weight[(i + 2) * K + k], inf.weight[(i + 3) * K + k]);
+
+            __m128 row[4];
+            GatherTranspose(matrices->m + 0, stride, b, row);
+            auto rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[0], px), _mm_mul_ps(row[1], py)),
+                                 _mm_add_ps(_mm_mul_ps(row[2], pz), row[3]));
+            GatherTranspose(matrices->m + 4, stride, b, row);
+            auto ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[0], px), _mm_mul_ps(row[1], py)),
+                                 _mm_add_ps(_mm_mul_ps(row[2], pz), row[3]));
+            GatherTranspose(matrices->m + 8, stride, b, row);
+            auto rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[0], px), _mm_mul_ps(row[1], py)),
+                                 _mm_add_ps(_mm_mul_ps(row[2], pz), row[3]));
+
+            x = _mm_add_ps(x, _mm_mul_ps(w, rx));
+            y = _mm_add_ps(y, _mm_mul_ps(w, ry));
+            z = _mm_add_ps(z, _mm_mul_ps(w, rz));
+        }
+
+        _mm_storeu_ps(out.x + i, x);
+        _mm_storeu_ps(out.y + i, y);
+        _mm_storeu_ps(out.z + i, z);
+    }
+
+    LinearScalar(matrices, in, inf, out, i, end);
+}
+
+
+static void
+RotorSSE(SkinBone const* bones, VecSoA const& in, SkinInfluences const& inf, VecSoA const& out, size_t begin, size_t end)
+{
+    auto const K      = inf.per_vertex;
+    auto const stride = sizeof(SkinBone) / sizeof(float);
+    auto const base   = &bones->R.s;
+    auto const zero   = _mm_setzero_ps();
+    auto const sign   = _mm_set1_ps(-0.0f);
+    auto const half   = _mm_set1_ps(0.5f);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 R0[4] = { zero, zero, zero, zero };
+        __m128 R[4]  = { zero, zero, zero, zero };
+        __m128 D[4]  = { zero, zero, zero, zero }; // e1, e2, e3, e123
+
+        for (int k = 0; k < K; ++k)
+        {
+            uint16_t b[4] = { inf.bone[(i + 0) * K + k], inf.bone[(i + 1) * K + k],
+                              inf.bone[(i + 2) * K + k], inf.bone[(i + 3) * K + k] };
+            auto     w    = _mm_setr_ps(inf.weight[(i + 0) * K + k], inf.weight[(i + 1) * K + k],
+                                        inf.weight[(i + 2) * K + k], inf.weight[(i + 3) * K + k]);
+
+            // Rotor is four contiguous floats: s, e12, e13, e23.
+            __m128 Rk[4];
+            GatherTranspose(base, stride, b, Rk);
+            if (k == 0)
+            {
+                R0[0] = Rk[0];
+                R0[1] = Rk[1];
+                R0[2] = Rk[2];
+                R0[3] = Rk[3];
+            }
+
+            auto tx = _mm_setr_ps(bones[b[0]].t.x, bones[b[1]].t.x, bones[b[2]].t.x, bones[b[3]].t.x);
+            auto ty = _mm_setr_ps(bones[b[0]].t.y, bones[b[1]].t.y, bones[b[2]].t.y, bones[b[3]].t.y);
+            auto tz = _mm_setr_ps(bones[b[0]].t.z, bones[b[1]].t.z, bones[b[2]].t.z, bones[b[3]].t.z);
+
+            // Flip w onto R0's hemisphere by copying the sign of the dot.
+            auto d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R0[0], Rk[0]), _mm_mul_ps(R0[1], Rk[1])),
+                                _mm_add_ps(_mm_mul_ps(R0[2], Rk[2]), _mm_mul_ps(R0[3], Rk[3])));
+            w      = _mm_xor_ps(w, _mm_and_ps(_mm_cmplt_ps(d, zero), sign));
+
+            R[0] = _mm_add_ps(R[0], _mm_mul_ps(w, Rk[0]));
+            R[1] = _mm_add_ps(R[1], _mm_mul_ps(w, Rk[1]));
+            R[2] = _mm_add_ps(R[2], _mm_mul_ps(w, Rk[2]));
+            R[3] = _mm_add_ps(R[3], _mm_mul_ps(w, Rk[3]));
+
+            // D += w/2 t R, as in DualPart.
+            auto hw = _mm_mul_ps(half, w);
+            auto d1 = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(tx, Rk[0]), _mm_mul_ps(ty, Rk[1])), _mm_mul_ps(tz, Rk[2]));
+            auto d2 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(ty, Rk[0]), _mm_mul_ps(tx, Rk[1])), _mm_mul_ps(tz, Rk[3]));
+            auto d3 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tz, Rk[0]), _mm_mul_ps(tx, Rk[2])), _mm_mul_ps(ty, Rk[3]));
+            auto d4 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(tx, Rk[3]), _mm_mul_ps(ty, Rk[2])), _mm_mul_ps(tz, Rk[1]));
+            D[0]    = _mm_add_ps(D[0], _mm_mul_ps(hw, d1));
+            D[1]    = _mm_add_ps(D[1], _mm_mul_ps(hw, d2));
+            D[2]    = _mm_add_ps(D[2], _mm_mul_ps(hw, d3));
+            D[3]    = _mm_add_ps(D[3], _mm_mul_ps(hw, d4));
+        }
+
+        auto l2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(R[0], R[0]), _mm_mul_ps(R[1], R[1])),
+                             _mm_add_ps(_mm_mul_ps(R[2], R[2]), _mm_mul_ps(R[3], R[3])));
+
+        // t = 2 <D ~R>_1 / |R|^2, as in Translation.
+        auto k2 = _mm_div_ps(_mm_set1_ps(2.0f), l2);
+        auto tx = _mm_mul_ps(k2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(D[0], R[0]), _mm_mul_ps(D[1], R[1])),
+                                            _mm_add_ps(_mm_mul_ps(D[2], R[2]), _mm_mul_ps(D[3], R[3]))));
+        auto ty = _mm_mul_ps(k2, _mm_sub_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(D[1], R[0]), _mm_mul_ps(D[0], R[1])), _mm_mul_ps(D[2], R[3])),
+                                            _mm_mul_ps(D[3], R[2])));
+        auto tz = _mm_mul_ps(k2, _mm_add_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(D[2], R[0]), _mm_mul_ps(D[0], R[2])), _mm_mul_ps(D[1], R[3])),
+                                            _mm_mul_ps(D[3], R[1])));
+
+        auto l   = _mm_sqrt_ps(l2);
+        auto s   = _mm_div_ps(R[0], l);
+        auto b12 = _mm_div_ps(R[1], l);
+        auto b13 = _mm_div_ps(R[2], l);
+        auto b23 = _mm_div_ps(R[3], l);
+
+        auto vx = _mm_loadu_ps(in.x + i);
+        auto vy = _mm_loadu_ps(in.y + i);
+        auto vz = _mm_loadu_ps(in.z + i);
+
+        // Vec_Rotate(R, v), as in batch_ops_kernels.inl.
+        auto wx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, s), _mm_mul_ps(vy, b12)), _mm_mul_ps(vz, b13));
+        auto wy = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vy, s), _mm_mul_ps(vx, b12)), _mm_mul_ps(vz, b23));
+        auto wz = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(vz, s), _mm_mul_ps(vx, b13)), _mm_mul_ps(vy, b23));
+        auto T  = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vx, b23), _mm_mul_ps(vy, b13)), _mm_mul_ps(vz, b12));
+
+        auto ox = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s, wx), _mm_mul_ps(wy, b12)), _mm_mul_ps(wz, b13)), _mm_mul_ps(b23, T));
+        auto oy = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(s, wy), _mm_mul_ps(wx, b12)), _mm_mul_ps(wz, b23)), _mm_mul_ps(b13, T));
+        auto oz = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(s, wz), _mm_mul_ps(wx, b13)), _mm_mul_ps(wy, b23)), _mm_mul_ps(b12, T));
+
+        _mm_storeu_ps(out.x + i, _mm_add_ps(ox, tx));
+        _mm_storeu_ps(out.y + i, _mm_add_ps(oy, ty));
+        _mm_storeu_ps(out.z + i, _mm_add_ps(oz, tz));
+    }
+
+    RotorScalar(bones, in, inf, out, i, end);
+}
+
+#endif
+
+
+void
+Skin_Linear(SkinMatrix const*     matrices,
+            VecSoA const&         in,
+            SkinInfluences const& influences,
+            VecSoA const&         out,
+            size_t                count,
+            int                   thread_count)
+{
+    assert(influences.per_vertex >= 1 && influences.per_vertex <= SKIN_MAX_INFLUENCES);
+
+    Batch_ParallelFor(count, 1024, thread_count, [&](size_t begin, size_t end) {
+#if defined(__SSE2__)
+        LinearSSE(matrices, in, influences, out, begin, end);
+#else
+        LinearScalar(matrices, in, influences, out, begin, end);
+#endif
+    });
+}
+
+
+void
+Skin_Rotor(SkinBone const*       bones,
+           VecSoA const&         in,
+           SkinInfluences const& influences,
+           VecSoA const&         out,
+           size_t                count,
+           int                   thread_count)
+{
+    assert(influences.per_vertex >= 1 && influences.per_vertex <= SKIN_MAX_INFLUENCES);
+
+    Batch_ParallelFor(count, 1024, thread_count, [&](size_t begin, size_t end) {
+#if defined(__SSE2__)
+        RotorSSE(bones, in, influences, out, begin, end);
+#else
+        RotorScalar(bones, in, influences, out, begin, end);
+#endif
+    });
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "GeometricAlgebra/batch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+#include <cstddef>
+#include <stdint.h>
+
+// Mesh skinning: deforms SoA vertex positions by a weighted blend of bone
+// transforms, in one pass over the vertices.
+//
+// A bone maps a point p to Vec_Rotate(R, p) + t. Each vertex has a fixed
+// number of influences (1 to SKIN_MAX_INFLUENCES); unused slots should have
+// weight 0. Weights are expected to sum to 1.
+
+
+#define SKIN_MAX_INFLUENCES 8
+
+
+struct SkinBone
+{
+    Rotor R;
+    Vec   t;
+};
+
+
+// A bone prepared for Skin_Linear: three rows of a 3x4 affine matrix,
+// [row r] = { Q r0, Q r1, Q r2, t r }.
+struct SkinMatrix
+{
+    float m[12];
+};
+
+
+// Packed influence streams. Vertex i's influences are
+// bone[i * per_vertex + k] and weight[i * per_vertex + k], k < per_vertex.
+struct SkinInfluences
+{
+    uint16_t const* bone;
+    float const*    weight;
+    int             per_vertex;
+};
+
+
+// Converts bones to matrices for Skin_Linear. Call once per frame.
+void
+Skin_PrepareMatrices(SkinBone const* bones, size_t bone_count, SkinMatrix* out);
+
+
+// Classic linear blend skinning: out = sum_k w_k (M_k p). Fast, but volume
+// collapses where bones twist far apart.
+void
+Skin_Linear(SkinMatrix const*     matrices,
+            VecSoA const&         in,
+            SkinInfluences const& influences,
+            VecSoA const&         out,
+            size_t                count,
+            int                   thread_count = 0);
+
+
+// Blends bone motors (dual quaternions) instead: each bone's rotor R and
+// dual part 1/2 t R are summed (flipped onto the first influence's
+// hemisphere), normalised, and applied once. Translation stays coupled to
+// rotation, so bones pivoting about any point blend rigidly and volume is
+// preserved under twist, at the cost of a normalise per vertex.
+void
+Skin_Rotor(SkinBone const*       bones,
+           VecSoA const&         in,
+           SkinInfluences const& influences,
+           VecSoA const&         out,
+           size_t                count,
+           int                   thread_count = 0);
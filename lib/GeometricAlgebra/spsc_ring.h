@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <stdlib.h>
+#include <string.h>
+
+// Lock-free single-producer/single-consumer ring buffer.
+//
+// Exactly one thread may call Push and exactly one thread may call Pop.
+// Both move items in batches: one acquire/release pair per call rather than
+// per item. Neither call blocks; when the ring is full (or empty) they move
+// fewer items than requested and the caller decides how to wait. That is
+// how backpressure propagates up a pipeline.
+//
+// T must be trivially copyable.
+
+
+#define SPSC_CACHE_LINE 64
+
+
+template <typename T>
+struct SpscRing
+{
+    T*     items;
+    size_t mask;
+
+    // Written by the consumer, read by the producer.
+    alignas(SPSC_CACHE_LINE) std::atomic<size_t> head;
+    size_t cached_tail;
+
+    // Written by the producer, read by the consumer.
+    alignas(SPSC_CACHE_LINE) std::atomic<size_t> tail;
+    size_t cached_head;
+
+    // Capacity is rounded up to a power of two.
+    explicit SpscRing(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        this->items       = (T*)aligned_alloc(SPSC_CACHE_LINE, (size * sizeof(T) + SPSC_CACHE_LINE - 1) & ~(size_t)(SPSC_CACHE_LINE - 1));
+        this->mask        = size - 1;
+        this->cached_tail = 0;
+        this->cached_head = 0;
+        this->head.store(0, std::memory_order_relaxed);
+        this->tail.store(0, std::memory_order_relaxed);
+    }
+
+    ~SpscRing()
+    {
+        free(this->items);
+    }
+
+    SpscRing(SpscRing const&) = delete;
+    SpscRing& operator=(SpscRing const&) = delete;
+
+    size_t
+    Capacity() const
+    {
+        return this->mask + 1;
+    }
+
+    // Producer side. Copies up to n items in; returns how many were taken.
+    size_t
+    Push(T const* src, size_t n)
+    {
+        auto t     = this->tail.load(std::memory_order_relaxed);
+        auto space = this->Capacity() - (t - this->cached_head);
+        if (space < n)
+        {
+            this->cached_head = this->head.load(std::memory_order_acquire);
+            space             = this->Capacity() - (t - this->cached_head);
+        }
+
+        n = n < space ? n : space;
+        this->Copy(this->items, t, src, n);
+        this->tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side. Copies up to n items out; returns how many were taken.
+    size_t
+    Pop(T* dst, size_t n)
+    {
+        auto h         = this->head.load(std::memory_order_relaxed);
+        auto available = this->cached_tail - h;
+        if (available < n)
+        {
+            this->cached_tail = this->tail.load(std::memory_order_acquire);
+            available         = this->cached_tail - h;
+        }
+
+        n = n < available ? n : available;
+        this->CopyOut(dst, h, n);
+        this->head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    // Approximate when called from a thread that is neither end.
+    size_t
+    Size() const
+    {
+        return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+    }
+
+private:
+    void
+    Copy(T* ring, size_t at, T const* src, size_t n)
+    {
+        auto start = at & this->mask;
+        auto first = n < this->Capacity() - start ? n : this->Capacity() - start;
+        memcpy(ring + start, src, first * sizeof(T));
+        memcpy(ring, src + first, (n - first) * sizeof(T));
+    }
+
+    void
+    CopyOut(T* dst, size_t at, size_t n)
+    {
+        auto start = at & this->mask;
+        auto first = n < this->Capacity() - start ? n : this->Capacity() - start;
+        memcpy(dst, this->items + start, first * sizeof(T));
+        memcpy(dst + first, this->items, (n - first) * sizeof(T));
+    }
+};
@@ -0,0 +1,251 @@
+#include "GeometricAlgebra/batch_ops.h"
+#include "GeometricAlgebra/cpu_dispatch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+static bool
+Near(float a, float b)
+{
+    return fabsf(a - b) <= 1e-5f * (1.0f + fabsf(a));
+}
+
+
+struct Rotors
+{
+    std::vector<float> s, e12, e13, e23;
+
+    explicit Rotors(size_t n)
+        : s(n), e12(n), e13(n), e23(n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            Rotor R(RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+            Geo_Normalise(R);
+            Set(i, R);
+        }
+    }
+
+    RotorSoA
+    SoA()
+    {
+        return { s.data(), e12.data(), e13.data(), e23.data() };
+    }
+
+    Rotor
+    Get(size_t i) const
+    {
+        return Rotor(s[i], e12[i], e13[i], e23[i]);
+    }
+
+    void
+    Set(size_t i, Rotor const& R)
+    {
+        s[i]   = R.s;
+        e12[i] = R.B.e12;
+        e13[i] = R.B.e13;
+        e23[i] = R.B.e23;
+    }
+};
+
+
+void
+Test_PathSelection()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto detected = Cpu_DetectPath();
+    printf("Detected: %s, active: %s\n", Cpu_PathName(detected), Cpu_PathName(Cpu_ActivePath()));
+
+    assert(Cpu_Supports(CpuPath_Scalar));
+    assert(Cpu_Supports(detected));
+    assert(!Cpu_SetPath(CpuPath_Count));
+
+    assert(Cpu_SetPath(CpuPath_Scalar));
+    assert(Cpu_ActivePath() == CpuPath_Scalar);
+    assert(Cpu_SetPath(detected));
+    assert(Cpu_ActivePath() == detected);
+}
+
+
+void
+Test_EveryPathMatchesScalarFunctions()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 1037; // Leaves a tail for every vector width.
+
+    Rotors X(count), Y(count);
+
+    std::vector<float> vx(count), vy(count), vz(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        vx[i] = RandomFloat();
+        vy[i] = RandomFloat();
+        vz[i] = RandomFloat();
+    }
+
+    auto initial = Cpu_ActivePath();
+    for (int path = 0; path < CpuPath_Count; ++path)
+    {
+        if (!Cpu_SetPath((CpuPath)path))
+        {
+            printf("  %s: not supported, skipped\n", Cpu_PathName((CpuPath)path));
+            continue;
+        }
+        printf("  %s\n", Cpu_PathName((CpuPath)path));
+
+        // Rotate.
+        std::vector<float> ox(count), oy(count), oz(count);
+        Batch_Rotate(X.SoA(), { vx.data(), vy.data(), vz.data() }, { ox.data(), oy.data(), oz.data() }, count, 2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto v = Vec_Rotate(X.Get(i), { vx[i], vy[i], vz[i] });
+            assert(Near(v.x, ox[i]) && Near(v.y, oy[i]) && Near(v.z, oz[i]));
+        }
+
+        // Geo_Mul.
+        Rotors XY(count);
+        Batch_GeoMul(X.SoA(), Y.SoA(), XY.SoA(), count, 2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto R = Geo_Mul(X.Get(i), Y.Get(i));
+            auto Q = XY.Get(i);
+            assert(Near(R.s, Q.s) && Near(R.B.e12, Q.B.e12) && Near(R.B.e13, Q.B.e13) && Near(R.B.e23, Q.B.e23));
+        }
+
+        // ToMatrix4.
+        std::vector<Matrix4> M(count);
+        Batch_ToMatrix4(X.SoA(), M.data(), count, 2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto expected = ToMatrix4(X.Get(i));
+            for (int k = 0; k < 16; ++k)
+            {
+                assert(Near(expected[k], M[i][k]));
+            }
+        }
+
+        // Normalise, in place.
+        Rotors N(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto R = N.Get(i);
+            N.Set(i, Rotor(R.s * 3.0f, R.B.e12 * 3.0f, R.B.e13 * 3.0f, R.B.e23 * 3.0f));
+        }
+        Rotors expected = N;
+        Batch_Normalise(N.SoA(), count, 2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto R = expected.Get(i);
+            Geo_Normalise(R);
+            auto Q = N.Get(i);
+            assert(Near(R.s, Q.s) && Near(R.B.e12, Q.B.e12) && Near(R.B.e13, Q.B.e13) && Near(R.B.e23, Q.B.e23));
+        }
+
+        // RotorFromMatrix4, round-tripping the matrices from above.
+        Rotors F(count);
+        Batch_RotorFromMatrix4(M.data(), F.SoA(), count, 2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto R = RotorFromMatrix4(M[i]);
+            auto Q = F.Get(i);
+            assert(Near(R.s, Q.s) && Near(R.B.e12, Q.B.e12) && Near(R.B.e13, Q.B.e13) && Near(R.B.e23, Q.B.e23));
+
+            auto sign = X.s[i] < 0.0f ? -1.0f : 1.0f;
+            assert(fabsf(Q.s - sign * X.s[i]) < 1e-4f && fabsf(Q.B.e12 - sign * X.e12[i]) < 1e-4f);
+            assert(fabsf(Q.B.e13 - sign * X.e13[i]) < 1e-4f && fabsf(Q.B.e23 - sign * X.e23[i]) < 1e-4f);
+        }
+    }
+    Cpu_SetPath(initial);
+}
+
+
+// Runs this test binary again with GA_CPU_PATH set and returns what it
+// prints for --print-path, stderr included.
+static std::string
+RunWithPath(char const* self, char const* value)
+{
+    std::string command = std::string("GA_CPU_PATH=") + value + " '" + self + "' --print-path 2>&1";
+    std::string output;
+#if defined(__unix__)
+    auto pipe = popen(command.c_str(), "r");
+    assert(pipe);
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe))
+    {
+        output += buffer;
+    }
+    assert(pclose(pipe) == 0);
+#endif
+    return output;
+}
+
+
+void
+Test_EnvironmentOverride(char const* self)
+{
+    printf(__func__);
+    printf("\n");
+
+#if defined(__unix__)
+    auto detected = Cpu_PathName(Cpu_DetectPath());
+
+    // A supported path is used as given; scalar always is.
+    assert(RunWithPath(self, "scalar") == "scalar\n");
+    assert(RunWithPath(self, detected) == std::string(detected) + "\n");
+
+    // An unknown name warns and falls back to the detected path.
+    auto unknown = RunWithPath(self, "avx9000");
+    assert(unknown.find("GA_CPU_PATH=avx9000 is not a known path") != std::string::npos);
+    assert(unknown.find(std::string("using ") + detected) != std::string::npos);
+    assert(unknown.substr(unknown.size() - strlen(detected) - 1) == std::string(detected) + "\n");
+
+    // A known path the CPU lacks also falls back, with a different warning.
+    for (int path = CpuPath_SSE4; path < CpuPath_Count; ++path)
+    {
+        if (!Cpu_Supports((CpuPath)path))
+        {
+            auto output = RunWithPath(self, Cpu_PathName((CpuPath)path));
+            assert(output.find("is not supported on this CPU") != std::string::npos);
+            break;
+        }
+    }
+#else
+    (void)self;
+    printf("  needs popen, skipped\n");
+#endif
+}
+
+
+int
+main(int argc, char** argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--print-path") == 0)
+    {
+        printf("%s\n", Cpu_PathName(Cpu_ActivePath()));
+        return 0;
+    }
+
+    Test_PathSelection();
+    Test_EveryPathMatchesScalarFunctions();
+    Test_EnvironmentOverride(argv[0]);
+
+    printf("%s PASSED\n", "test_batch_ops.cpp");
+}
@@ -0,0 +1,283 @@
+#include "GeometricAlgebra/clifford.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(__unix__)
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+static Rotor
+RandomRotor()
+{
+    Rotor R(RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+    Geo_Normalise(R);
+    return R;
+}
+
+
+static bool
+Near(float a, float b)
+{
+    return fabsf(a - b) < 1e-4f;
+}
+
+
+static bool
+Near(Vec const& a, Vec const& b)
+{
+    return Near(a.x, b.x) && Near(a.y, b.y) && Near(a.z, b.z);
+}
+
+
+static bool
+Near(Rotor const& a, Rotor const& b)
+{
+    return Near(a.s, b.s)
+        && Near(a.B.e12, b.B.e12)
+        && Near(a.B.e13, b.B.e13)
+        && Near(a.B.e23, b.B.e23);
+}
+
+
+void
+Test_BladeSigns()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto A = Cl_GetAlgebra(3, 0);
+    assert(A == Cl_GetAlgebra(3, 0, 0)); // Tables are cached.
+    assert(A->blade_count == 8);
+
+    assert(Cl_Sign(A, 0b001, 0b001) == +1); // e1e1 = 1
+    assert(Cl_Sign(A, 0b001, 0b010) == +1); // e1e2 = e12
+    assert(Cl_Sign(A, 0b010, 0b001) == -1); // e2e1 = -e12
+    assert(Cl_Sign(A, 0b011, 0b011) == -1); // e12e12 = -1
+
+    // Spacetime algebra Cl(1,3): e2 squares to -1.
+    auto STA = Cl_GetAlgebra(1, 3);
+    assert(Cl_Sign(STA, 0b0001, 0b0001) == +1);
+    assert(Cl_Sign(STA, 0b0010, 0b0010) == -1);
+
+    // PGA Cl(3,0,1): e4 squares to 0.
+    auto PGA = Cl_GetAlgebra(3, 0, 1);
+    assert(Cl_Sign(PGA, 0b1000, 0b1000) == 0);
+    assert(Cl_Sign(PGA, 0b1001, 0b0001) == -1);
+
+    assert(Cl_GetAlgebra(CL_MAX_DIMENSION + 1, 0) == nullptr);
+}
+
+
+void
+Test_VecMulMatchesCl3()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto A     = Cl_GetAlgebra(3, 0);
+    auto arena = Cl_ArenaCreate(4096);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Vec u = Vec_Normalise({ RandomFloat(), RandomFloat(), RandomFloat() });
+        Vec v = Vec_Normalise({ RandomFloat(), RandomFloat(), RandomFloat() });
+
+        auto R  = Rotor(Vec_Mul(u, v));
+        auto UV = Cl_Mul(arena, Cl_FromVec(A, arena, u), Cl_FromVec(A, arena, v));
+
+        // Vec_Mul normalises, and the product of unit vectors is unit length.
+        assert(Near(R, Cl_ToRotor(UV)));
+
+        auto B = Vec_Wedge(u, v);
+        auto W = Cl_Wedge(arena, Cl_FromVec(A, arena, u), Cl_FromVec(A, arena, v));
+        assert(Near(Cl_Get(W, 0b011), B.e12));
+        assert(Near(Cl_Get(W, 0b101), B.e13));
+        assert(Near(Cl_Get(W, 0b110), B.e23));
+
+        Cl_ArenaReset(arena);
+    }
+
+    Cl_ArenaDestroy(arena);
+}
+
+
+void
+Test_RotateMatchesCl3()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto A     = Cl_GetAlgebra(3, 0);
+    auto arena = Cl_ArenaCreate(4096);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto R = RandomRotor();
+        Vec  v { RandomFloat(), RandomFloat(), RandomFloat() };
+
+        auto before = Cl_ArenaMark(arena);
+        auto Rv     = Cl_Sandwich(arena, Cl_FromRotor(A, arena, R), Cl_FromVec(A, arena, v));
+
+        assert(Near(Vec_Rotate(R, v), Cl_ToVec(Rv)));
+        assert(Near(Cl_Get(Rv, 0b111), 0.0f));
+
+        Cl_ArenaRewind(arena, before);
+        assert(Cl_ArenaMark(arena) == before);
+    }
+
+    Cl_ArenaDestroy(arena);
+}
+
+
+void
+Test_GeoMulMatchesCl3()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto A     = Cl_GetAlgebra(3, 0);
+    auto arena = Cl_ArenaCreate(4096);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto X = RandomRotor();
+        auto Y = RandomRotor();
+        Vec  v { RandomFloat(), RandomFloat(), RandomFloat() };
+
+        // Composition: XY applied to v is X applied to (Y applied to v).
+        auto XY = Cl_Mul(arena, Cl_FromRotor(A, arena, X), Cl_FromRotor(A, arena, Y));
+        assert(Near(Vec_Rotate(Cl_ToRotor(XY), v), Vec_Rotate(X, Vec_Rotate(Y, v))));
+
+        // Geo_Mul's e12 cross term (p_b02 * q_b12 - p_b12 * q_b02) has the
+        // opposite sign to the Cl(3,0) product, so the two only agree when
+        // that term vanishes, i.e. when either rotor lies in the e12 plane.
+        auto Z = Rotor(X.s, X.B.e12, 0.0f, 0.0f);
+        Geo_Normalise(Z);
+
+        auto ZY = Cl_Mul(arena, Cl_FromRotor(A, arena, Z), Cl_FromRotor(A, arena, Y));
+        auto YZ = Cl_Mul(arena, Cl_FromRotor(A, arena, Y), Cl_FromRotor(A, arena, Z));
+        assert(Near(Geo_Mul(Z, Y), Cl_ToRotor(ZY)));
+        assert(Near(Geo_Mul(Y, Z), Cl_ToRotor(YZ)));
+
+        Cl_ArenaReset(arena);
+    }
+
+    Cl_ArenaDestroy(arena);
+}
+
+
+void
+Test_HigherDimensions()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto A     = Cl_GetAlgebra(4, 0);
+    auto arena = Cl_ArenaCreate(4096);
+
+    // Rotation in the e34 plane leaves e1 and e2 alone, and does a
+    // quarter-turn of e3 into e4 for a rotor of half-angle pi/4.
+    float const h = (float)M_SQRT1_2;
+    auto R = Cl_Add(arena, Cl_Scalar(A, arena, h), Cl_FromBlade(A, arena, 0b1100, -h));
+
+    float const e1[4] = { 1, 0, 0, 0 };
+    float const e3[4] = { 0, 0, 1, 0 };
+    auto        r1    = Cl_Sandwich(arena, R, Cl_FromVector(A, arena, e1));
+    auto        r3    = Cl_Sandwich(arena, R, Cl_FromVector(A, arena, e3));
+    Print("R e1 ~R: ", r1);
+    Print("R e3 ~R: ", r3);
+
+    assert(Near(Cl_Get(r1, 0b0001), 1.0f));
+    assert(Near(Cl_Get(r3, 0b0100), 0.0f));
+    assert(Near(fabsf(Cl_Get(r3, 0b1000)), 1.0f));
+
+    // The pseudoscalar of Cl(4,0) squares to +1.
+    auto I  = Cl_FromBlade(A, arena, 0b1111, 1.0f);
+    auto II = Cl_Mul(arena, I, I);
+    assert(II.count == 1 && Near(Cl_Get(II, 0), 1.0f));
+
+    Cl_ArenaDestroy(arena);
+}
+
+
+static Cl_Multivector
+Dense(Cl_Algebra const* A, Cl_Arena& arena)
+{
+    Cl_Multivector M;
+    M.algebra = A;
+    M.blades = (Blade*)Cl_ArenaAlloc(arena, A->blade_count * sizeof(Blade), alignof(Blade));
+    M.coeffs = (float*)Cl_ArenaAlloc(arena, A->blade_count * sizeof(float), alignof(float));
+    M.count  = A->blade_count;
+    for (uint32_t b = 0; b < M.count; ++b)
+    {
+        M.blades[b] = b;
+        M.coeffs[b] = RandomFloat();
+    }
+    return M;
+}
+
+
+void
+Test_ArenaBudget()
+{
+    printf(__func__);
+    printf("\n");
+
+    // The documented 32N bytes is enough for the worst case: a sandwich of
+    // two fully dense multivectors in Cl(10).
+    auto   A      = Cl_GetAlgebra(10, 0);
+    size_t budget = 32 * A->blade_count;
+    auto   inputs = Cl_ArenaCreate(4 * budget);
+    auto   arena  = Cl_ArenaCreate(budget);
+    auto   R      = Dense(A, inputs);
+    auto   X      = Dense(A, inputs);
+
+    auto M = Cl_Sandwich(arena, R, X);
+    assert(M.count <= A->blade_count);
+    assert(arena.used <= 8 * A->blade_count + 8);
+
+#if defined(__unix__)
+    // Running out is fatal in every build, not a null result.
+    fflush(stdout);
+    pid_t child = fork();
+    if (child == 0)
+    {
+        auto small = Cl_ArenaCreate(4096);
+        Cl_Mul(small, R, X);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+#endif
+
+    Cl_ArenaDestroy(arena);
+    Cl_ArenaDestroy(inputs);
+}
+
+
+int
+main(void)
+{
+    Test_BladeSigns();
+    Test_VecMulMatchesCl3();
+    Test_RotateMatchesCl3();
+    Test_GeoMulMatchesCl3();
+    Test_HigherDimensions();
+    Test_ArenaBudget();
+
+    printf("%s PASSED\n", "test_clifford.cpp");
+}
@@ -0,0 +1,389 @@
+#include "GeometricAlgebra/compact_vec.h"
+#include "GeometricAlgebra/cpu_dispatch.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+static bool
+Near(Vec const& a, Vec const& b, float eps)
+{
+    return fabsf(a.x - b.x) < eps && fabsf(a.y - b.y) < eps && fabsf(a.z - b.z) < eps;
+}
+
+
+struct Points
+{
+    std::vector<float> x, y, z;
+
+    Points(size_t count, float extent = 1.0f, Vec centre = Vec_Zero())
+        : x(count), y(count), z(count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] = centre.x + extent * RandomFloat();
+            y[i] = centre.y + extent * RandomFloat();
+            z[i] = centre.z + extent * RandomFloat();
+        }
+    }
+
+    VecSoA
+    View()
+    {
+        return { x.data(), y.data(), z.data() };
+    }
+
+    Vec
+    operator[](size_t i) const
+    {
+        return { x[i], y[i], z[i] };
+    }
+};
+
+
+struct HalfPoints
+{
+    std::vector<uint16_t> x, y, z;
+
+    explicit HalfPoints(size_t count)
+        : x(count), y(count), z(count)
+    {
+    }
+
+    VecHalfSoA
+    View()
+    {
+        return { x.data(), y.data(), z.data() };
+    }
+
+    bool
+    operator==(HalfPoints const& other) const
+    {
+        return x == other.x && y == other.y && z == other.z;
+    }
+};
+
+
+static Rotor
+RandomRotor()
+{
+    Rotor R(RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+    Geo_Normalise(R);
+    return R;
+}
+
+
+void
+Test_HalfConversion()
+{
+    printf(__func__);
+    printf("\n");
+
+    // Exactly representable values survive the round trip.
+    for (float f : { 0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, 0.000061035156f, 0.000000059604645f })
+    {
+        assert(Half_ToFloat(Half_FromFloat(f)) == f);
+    }
+    assert(Half_FromFloat(1.0f) == 0x3c00);
+    assert(Half_FromFloat(-2.0f) == 0xc000);
+    assert(Half_FromFloat(1e6f) == 0x7c00);
+    assert(isnan(Half_ToFloat(Half_FromFloat(NAN))));
+
+    // Ties round to even: 1 + 2^-11 is halfway between 1 and 1 + 2^-10.
+    assert(Half_FromFloat(1.0f + 0.00048828125f) == 0x3c00);
+    assert(Half_FromFloat(1.0f + 3 * 0.00048828125f) == 0x3c02);
+
+    // Every half decodes to a float that encodes back to it.
+    for (uint32_t h = 0; h < 0x10000; ++h)
+    {
+        if ((h & 0x7c00) == 0x7c00 && (h & 0x03ff))
+        {
+            continue; // NaN payloads are not preserved.
+        }
+        assert(Half_FromFloat(Half_ToFloat((uint16_t)h)) == h);
+    }
+}
+
+
+void
+Test_HalfPathsAgree()
+{
+    printf(__func__);
+    printf("\n");
+
+    if (!Cpu_HasF16C() || !Cpu_Supports(CpuPath_AVX2))
+    {
+        printf("  F16C not available, skipped\n");
+        return;
+    }
+
+    size_t const count  = 1037;
+    auto         active = Cpu_ActivePath();
+    auto         R      = RandomRotor();
+    Points       points(count, 100.0f);
+    Vec          p = { 1.0f, -2.0f, 3.0f };
+
+    // Zero vectors in the scalar head and inside a vector chunk.
+    size_t const zeros[2] = { 0, 9 };
+    for (auto i : zeros)
+    {
+        points.x[i] = points.y[i] = points.z[i] = 0.0f;
+    }
+
+    HalfPoints         encoded[2]    = { HalfPoints(count), HalfPoints(count) };
+    HalfPoints         rotated[2]    = { HalfPoints(count), HalfPoints(count) };
+    HalfPoints         normalised[2] = { HalfPoints(count), HalfPoints(count) };
+    std::vector<float> distance[2]   = { std::vector<float>(count), std::vector<float>(count) };
+
+    CpuPath paths[2] = { CpuPath_Scalar, CpuPath_AVX2 };
+    for (int k = 0; k < 2; ++k)
+    {
+        Cpu_SetPath(paths[k]);
+        VecHalf_Encode(points.View(), encoded[k].View(), count, 2);
+        VecHalf_Rotate(R, encoded[k].View(), rotated[k].View(), count, 2);
+        VecHalf_Normalise(encoded[k].View(), normalised[k].View(), count, 2);
+        VecHalf_Distance(encoded[k].View(), p, distance[k].data(), count, 2);
+    }
+    Cpu_SetPath(active);
+
+    assert(encoded[0] == encoded[1]);
+    assert(rotated[0] == rotated[1]);
+    assert(normalised[0] == normalised[1]);
+    for (auto i : zeros)
+    {
+        // Zero vectors stay zero rather than NaN, as in VecQ16_Normalise.
+        assert(normalised[0].x[i] == 0 && normalised[0].y[i] == 0 && normalised[0].z[i] == 0);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(fabsf(distance[0][i] - distance[1][i]) <= 1e-6f * distance[0][i]);
+    }
+}
+
+
+void
+Test_HalfOperations()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const       count = 1001;
+    auto               R     = RandomRotor();
+    Points             points(count, 4.0f);
+    Points             decoded(count);
+    HalfPoints         half(count);
+    std::vector<float> distance(count);
+    Vec                p = { 0.5f, 1.0f, -1.5f };
+
+    // fp16 has an 11-bit significand: relative error 2^-11 per store.
+    float const eps = 4.0f * 8.0f / 2048.0f;
+
+    VecHalf_Encode(points.View(), half.View(), count);
+    VecHalf_Decode(half.View(), decoded.View(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(Near(points[i], decoded[i], eps));
+    }
+
+    VecHalf_Distance(half.View(), p, distance.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(fabsf(distance[i] - Vec_Distance(points[i], p)) < 2.0f * eps);
+    }
+
+    // In place.
+    VecHalf_Rotate(R, half.View(), half.View(), count, 3);
+    VecHalf_Decode(half.View(), decoded.View(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(Near(Vec_Rotate(R, points[i]), decoded[i], 2.0f * eps));
+    }
+
+    VecHalf_Encode(points.View(), half.View(), count);
+    VecHalf_Normalise(half.View(), half.View(), count, 3);
+    VecHalf_Decode(half.View(), decoded.View(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(Near(Vec_Normalise(points[i]), decoded[i], 4.0f / 2048.0f));
+    }
+}
+
+
+void
+Test_Q16Operations()
+{
+    printf(__func__);
+    printf("\n");
+
+    // Far from the origin: block-relative storage keeps precision that a
+    // global fixed-point or fp16 encoding would lose.
+    size_t const             count  = 1000; // Partial last block.
+    Vec const                centre = { 5000.0f, -3000.0f, 200.0f };
+    auto                     R      = RandomRotor();
+    Points                   points(count, 2.0f, centre);
+    Points                   decoded(count);
+    std::vector<VecQ16Block> blocks(VecQ16_BlockCount(count));
+    std::vector<float>       distance(count);
+    Vec                      p = centre + Vec{ 1.0f, 1.0f, 1.0f };
+
+    assert(blocks.size() == 16);
+
+    // Quantisation step is extent / 32767 per axis, plus float rounding of
+    // the large offset.
+    float const eps = 2.0f / 32767.0f + 5000.0f * 2e-7f;
+
+    VecQ16_Encode(points.View(), blocks.data(), count, 2);
+    VecQ16_Decode(blocks.data(), decoded.View(), count, 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(Near(points[i], decoded[i], eps));
+    }
+
+    VecQ16_Distance(blocks.data(), p, distance.data(), count, 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(fabsf(distance[i] - Vec_Distance(points[i], p)) < 2.0f * eps);
+    }
+
+    VecQ16_Rotate(R, blocks.data(), count, 3);
+    VecQ16_Decode(blocks.data(), decoded.View(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(Near(Vec_Rotate(R, points[i]), decoded[i], 4.0f * eps));
+    }
+
+    VecQ16_Encode(points.View(), blocks.data(), count);
+    VecQ16_Normalise(blocks.data(), count, 3);
+    VecQ16_Decode(blocks.data(), decoded.View(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(Near(Vec_Normalise(points[i]), decoded[i], 2.0f / 32767.0f + 1e-6f));
+    }
+
+    // Zero vectors normalise to zero rather than NaN. This block is centred
+    // on the origin, so its padding slots stay zero too.
+    {
+        Points two(2);
+        two.x[0] = two.y[0] = two.z[0] = 1.0f;
+        two.x[1] = two.y[1] = two.z[1] = -1.0f;
+        VecQ16Block pair;
+        VecQ16_Encode(two.View(), &pair, 2);
+        VecQ16_Normalise(&pair, 2);
+        VecQ16_Decode(&pair, decoded.View(), 2);
+        auto r = 1.0f / sqrtf(3.0f);
+        assert(Near(decoded[0], { r, r, r }, 1e-4f) && Near(decoded[1], { -r, -r, -r }, 1e-4f));
+        for (int j = 2; j < VEC_Q16_BLOCK; ++j)
+        {
+            assert(pair.x[j] == 0 && pair.y[j] == 0 && pair.z[j] == 0);
+        }
+    }
+
+    // A NaN component encodes as 0, so it decodes to the block centre on
+    // that axis, and stays finite through normalisation.
+    {
+        Points nan(VEC_Q16_BLOCK, 2.0f, centre);
+        nan.y[5] = NAN;
+        VecQ16Block block;
+        VecQ16_Encode(nan.View(), &block, VEC_Q16_BLOCK);
+        VecQ16_Decode(&block, decoded.View(), VEC_Q16_BLOCK);
+        assert(block.y[5] == 0 && decoded.y[5] == block.offset.y);
+        assert(fabsf(decoded.y[5] - centre.y) <= 2.0f);
+        for (size_t i = 0; i < VEC_Q16_BLOCK; ++i)
+        {
+            assert(Near(nan[i], decoded[i], eps) || i == 5);
+        }
+
+        VecQ16_Normalise(&block, VEC_Q16_BLOCK);
+        VecQ16_Decode(&block, decoded.View(), VEC_Q16_BLOCK);
+        for (size_t i = 0; i < VEC_Q16_BLOCK; ++i)
+        {
+            assert(isfinite(decoded.x[i]) && isfinite(decoded.y[i]) && isfinite(decoded.z[i]));
+        }
+    }
+
+    // A block of identical points has zero extent and decodes exactly.
+    Points same(VEC_Q16_BLOCK);
+    for (size_t i = 0; i < VEC_Q16_BLOCK; ++i)
+    {
+        same.x[i] = 1.5f;
+        same.y[i] = -2.0f;
+        same.z[i] = 3.25f;
+    }
+    VecQ16Block block;
+    VecQ16_Encode(same.View(), &block, VEC_Q16_BLOCK);
+    VecQ16_Decode(&block, decoded.View(), VEC_Q16_BLOCK);
+    for (size_t i = 0; i < VEC_Q16_BLOCK; ++i)
+    {
+        assert(decoded.x[i] == 1.5f && decoded.y[i] == -2.0f && decoded.z[i] == 3.25f);
+    }
+}
+
+
+void
+Test_Q16RepeatedRotation()
+{
+    printf(__func__);
+    printf("\n");
+
+    // Rotating in place many times must not let the block bounds grow, or
+    // the quantisation step grows with them.
+    size_t const             count = 200;
+    Points                   points(count);
+    Points                   decoded(count);
+    std::vector<VecQ16Block> blocks(VecQ16_BlockCount(count));
+
+    VecQ16_Encode(points.View(), blocks.data(), count);
+
+    std::vector<Vec> expected(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        expected[i] = points[i];
+    }
+
+    for (int n = 1; n <= 100; ++n)
+    {
+        auto R = RandomRotor();
+        VecQ16_Rotate(R, blocks.data(), count);
+        for (auto& v : expected)
+        {
+            v = Vec_Rotate(R, v);
+        }
+
+        // Points lie within sqrt(3) of the origin, so no block extent can
+        // exceed that, and the error grows at most one step per rotation.
+        for (auto const& block : blocks)
+        {
+            assert(block.scale.x * 32767.0f <= 1.75f && block.scale.y * 32767.0f <= 1.75f && block.scale.z * 32767.0f <= 1.75f);
+        }
+
+        VecQ16_Decode(blocks.data(), decoded.View(), count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            assert(Near(expected[i], decoded[i], n * 2.0f * 1.75f / 32767.0f + 1e-5f));
+        }
+    }
+}
+
+
+int
+main(void)
+{
+    Test_HalfConversion();
+    Test_HalfPathsAgree();
+    Test_HalfOperations();
+    Test_Q16Operations();
+    Test_Q16RepeatedRotation();
+
+    printf("%s PASSED\n", "test_compact_vec.cpp");
+}
@@ -0,0 +1,95 @@
+#include "GeometricAlgebra/euler_cache.h"
+#include "GeometricAlgebra/geometric_algebra.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static bool
+Near(Rotor const& a, Rotor const& b)
+{
+    auto eps = 1e-5f;
+    return fabsf(a.s - b.s) < eps
+        && fabsf(a.B.e12 - b.B.e12) < eps
+        && fabsf(a.B.e13 - b.B.e13) < eps
+        && fabsf(a.B.e23 - b.B.e23) < eps;
+}
+
+
+void
+Test_MatchesRotorFromEuler()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto cache = EulerCache_Create(4096, 0); // Tables only.
+    auto step  = cache->radians_per_tick;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        int32_t y = rand() % 8192 - 4096;
+        int32_t p = rand() % 8192 - 4096;
+        int32_t r = rand() % 8192 - 4096;
+
+        auto expected = RotorFromEuler(y * step, p * step, r * step);
+        assert(Near(expected, EulerCache_Rotor(cache, y, p, r)));
+        assert(Near(expected, EulerCache_RotorFromEuler(cache, y * step, p * step, r * step)));
+    }
+
+    // Two full turns bring the half-angle back round; one turn negates the
+    // rotor but not the rotation.
+    auto R  = EulerCache_Rotor(cache, 100, 200, 300);
+    auto R2 = EulerCache_Rotor(cache, 100 + 8192, 200 - 8192, 300);
+    assert(Near(R, R2));
+
+    auto R1 = EulerCache_Rotor(cache, 100 + 4096, 200, 300);
+    assert(Near(R, Rotor(-R1.s, -R1.B.e12, -R1.B.e13, -R1.B.e23)));
+
+    assert(EulerCache_Stats(cache).hits == 0);
+    EulerCache_Destroy(cache);
+}
+
+
+void
+Test_HitRate()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto cache = EulerCache_Create(1024, 1024);
+
+    // A few hundred distinct inputs, revisited over and over.
+    for (int pass = 0; pass < 50; ++pass)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            auto R = EulerCache_Rotor(cache, i, 2 * i, -i);
+            assert(Near(R, EulerCache_Rotor(cache, i, 2 * i, -i)));
+        }
+    }
+
+    auto stats = EulerCache_Stats(cache);
+    printf("lookups %llu, hits %llu, hit rate %.3f\n",
+           (unsigned long long)stats.lookups, (unsigned long long)stats.hits, EulerCache_HitRate(cache));
+
+    assert(stats.lookups == 50 * 200 * 2);
+    assert(EulerCache_HitRate(cache) > 0.9f);
+
+    EulerCache_ResetStats(cache);
+    assert(EulerCache_Stats(cache).lookups == 0);
+    assert(EulerCache_HitRate(cache) == 0.0f);
+
+    EulerCache_Destroy(cache);
+}
+
+
+int
+main(void)
+{
+    Test_MatchesRotorFromEuler();
+    Test_HitRate();
+
+    printf("%s PASSED\n", "test_euler_cache.cpp");
+}
@@ -408,6 +408,67 @@ Test_RotationCompositionAndRotationMatrix()
 }
 
 
+void
+Test_RotorFromMatrix4RoundTrip()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto near = [](float a, float b) { return fabsf(a - b) < 1e-5f; };
+
+    // Rotors and their negation give the same matrix, so compare matrices,
+    // and compare rotors up to sign.
+    Rotor rotors[] = {
+        Rotor(),
+        RotorFromEuler(0.3f, -1.2f, 2.5f),
+        Rotor(0.0f, 1.0f, 0.0f, 0.0f),     // Half-turns about each axis.
+        Rotor(0.0f, 0.0f, 1.0f, 0.0f),
+        Rotor(0.0f, 0.0f, 0.0f, 1.0f),
+        Rotor(0.0f, 0.6f, 0.0f, 0.8f),     // Half-turn about an oblique axis.
+        Rotor(-0.5f, 0.5f, -0.5f, 0.5f),
+        Rotor(1e-4f, 0.577f, -0.577f, 0.577f),
+    };
+
+    for (auto R : rotors)
+    {
+        Geo_Normalise(R);
+
+        auto M = ToMatrix4(R);
+        auto Q = RotorFromMatrix4(M);
+        auto N = ToMatrix4(Q);
+
+        for (int k = 0; k < 16; ++k)
+        {
+            assert(near(M[k], N[k]));
+        }
+
+        auto sign = (R.s < 0.0f) ? -1.0f : 1.0f;
+        if (R.s == 0.0f)
+        {
+            // Half-turn: s is 0 so the sign is free; match on the largest part.
+            sign = (R.B.e12 * Q.B.e12 + R.B.e13 * Q.B.e13 + R.B.e23 * Q.B.e23) < 0.0f ? -1.0f : 1.0f;
+        }
+        assert(Q.s >= 0.0f);
+        assert(near(Q.s, sign * R.s));
+        assert(near(Q.B.e12, sign * R.B.e12));
+        assert(near(Q.B.e13, sign * R.B.e13));
+        assert(near(Q.B.e23, sign * R.B.e23));
+    }
+
+    // Sweep Euler angles through every branch of the trace method.
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto R = RotorFromEuler(i * 0.037f, i * -0.061f, i * 0.013f);
+        auto M = ToMatrix4(R);
+        auto N = ToMatrix4(RotorFromMatrix4(M));
+        for (int k = 0; k < 16; ++k)
+        {
+            assert(near(M[k], N[k]));
+        }
+    }
+}
+
+
 int
 main(void)
 {
@@ -420,6 +481,7 @@ main(void)
     // Test_RotateByMultiVector();
     Test_Rotate3D();
     Test_RotationCompositionAndRotationMatrix();
+    Test_RotorFromMatrix4RoundTrip();
 
     printf("%s PASSED\n", "test_basic_operators.cpp");
 }
\ No newline at end of file
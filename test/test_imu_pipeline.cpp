@@ -0,0 +1,170 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/imu_pipeline.h"
+#include "GeometricAlgebra/spsc_ring.h"
+
+#include <cassert>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+
+void
+Test_RingWrapsAndBackpressures()
+{
+    printf(__func__);
+    printf("\n");
+
+    SpscRing<int> ring(5);
+    assert(ring.Capacity() == 8);
+
+    int in[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    int out[10];
+
+    assert(ring.Push(in, 6) == 6);
+    assert(ring.Pop(out, 4) == 4);
+    assert(out[0] == 0 && out[3] == 3);
+
+    // Full after 6 more: only 6 of 10 fit, wrapping past the end.
+    assert(ring.Push(in, 10) == 6);
+    assert(ring.Size() == 8);
+    assert(ring.Push(in, 1) == 0);
+
+    assert(ring.Pop(out, 10) == 8);
+    assert(out[0] == 4 && out[1] == 5 && out[2] == 0 && out[7] == 5);
+    assert(ring.Pop(out, 1) == 0);
+}
+
+
+void
+Test_PipelineMatchesSequential()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 100000;
+
+    auto config              = ImuPipeline_DefaultConfig();
+    config.radians_per_count = (float)(2.0 * M_PI / 4096.0);
+    config.calibration       = RotorFromEuler(0.1f, -0.2f, 0.3f);
+    config.ring_capacity     = 256; // Small, so backpressure kicks in.
+    config.batch_size        = 32;
+
+    std::vector<ImuRawSample> samples(count);
+    for (auto& s : samples)
+    {
+        s = { rand() % 4096, rand() % 4096, rand() % 4096 };
+    }
+
+    auto pipeline = ImuPipeline_Create(config);
+
+    std::thread producer([&]() {
+        size_t sent = 0;
+        while (sent < count)
+        {
+            auto n = count - sent < 100 ? count - sent : 100;
+            sent += ImuPipeline_Push(pipeline, samples.data() + sent, n);
+            if (sent < count)
+            {
+                std::this_thread::yield();
+            }
+        }
+        ImuPipeline_Close(pipeline);
+    });
+
+    std::vector<Matrix4> results;
+    Matrix4              batch[64];
+    while (!ImuPipeline_Finished(pipeline))
+    {
+        auto n = ImuPipeline_Pop(pipeline, batch, 64);
+        results.insert(results.end(), batch, batch + n);
+        if (n == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    ImuPipeline_Destroy(pipeline);
+
+    assert(results.size() == count);
+    auto const k = config.radians_per_count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto R = RotorFromEuler(samples[i].yaw * k, samples[i].pitch * k, samples[i].roll * k);
+        auto M = ToMatrix4(Geo_Mul(config.calibration, R));
+        assert(memcmp(&M, &results[i], sizeof(Matrix4)) == 0);
+    }
+}
+
+
+void
+Test_DestroyWhileBackedUp()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto config          = ImuPipeline_DefaultConfig();
+    config.ring_capacity = 16;
+    auto pipeline        = ImuPipeline_Create(config);
+
+    // Nobody pops, so every ring fills; Destroy must still return.
+    ImuRawSample s { 1, 2, 3 };
+    for (int i = 0; i < 1000; ++i)
+    {
+        ImuPipeline_Push(pipeline, &s, 1);
+    }
+    ImuPipeline_Destroy(pipeline);
+}
+
+
+void
+Test_IdleStagesSleep()
+{
+    printf(__func__);
+    printf("\n");
+
+    // Three idle stages must end up sleeping. Each stage waits through 128
+    // spins and yields and a few short sleeps, then about once per
+    // millisecond; spinning or yielding forever would wake hundreds of
+    // thousands of times. Counting wakes rather than CPU time, and scaling
+    // the bound by the measured wall time, keeps this independent of load.
+    auto pipeline = ImuPipeline_Create(ImuPipeline_DefaultConfig());
+
+    auto wall_start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    auto waits   = ImuPipeline_IdleWaits(pipeline);
+    auto wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+
+    assert(waits > 0);
+    assert((double)waits < 3.0 * (200.0 + wall_ms));
+
+    // Still responsive after idling.
+    ImuRawSample sample = { 0, 0, 0 };
+    assert(ImuPipeline_Push(pipeline, &sample, 1) == 1);
+    ImuPipeline_Close(pipeline);
+    Matrix4 m;
+    size_t  popped = 0;
+    while (!ImuPipeline_Finished(pipeline))
+    {
+        popped += ImuPipeline_Pop(pipeline, &m, 1);
+    }
+    assert(popped == 1 && m[0] == 1.0f);
+
+    ImuPipeline_Destroy(pipeline);
+}
+
+
+int
+main(void)
+{
+    Test_RingWrapsAndBackpressures();
+    Test_PipelineMatchesSequential();
+    Test_DestroyWhileBackedUp();
+    Test_IdleStagesSleep();
+
+    printf("%s PASSED\n", "test_imu_pipeline.cpp");
+}
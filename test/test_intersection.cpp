@@ -0,0 +1,238 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/intersection.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+struct Vecs
+{
+    std::vector<float> x, y, z;
+
+    explicit Vecs(size_t n)
+        : x(n), y(n), z(n)
+    {
+    }
+
+    VecSoA
+    SoA()
+    {
+        return { x.data(), y.data(), z.data() };
+    }
+
+    Vec
+    Get(size_t i) const
+    {
+        return { x[i], y[i], z[i] };
+    }
+
+    void
+    Set(size_t i, Vec const& v)
+    {
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+
+    void
+    Randomise()
+    {
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            Set(i, { RandomFloat(), RandomFloat(), RandomFloat() });
+        }
+    }
+};
+
+
+static Vec
+Cross(Vec const& a, Vec const& b)
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+
+void
+Test_RayPlane()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 1001;
+
+    Vecs O(count), D(count), P(count), U(count), V(count);
+    O.Randomise();
+    D.Randomise();
+    P.Randomise();
+    U.Randomise();
+    V.Randomise();
+
+    // Plane 0: z = 1 seen from the origin looking up.
+    O.Set(0, { 0, 0, 0 });
+    D.Set(0, { 0, 0, 1 });
+    P.Set(0, { 5, 5, 1 });
+    U.Set(0, { 1, 0, 0 });
+    V.Set(0, { 0, 1, 0 });
+
+    // Ray 1 runs parallel to its plane.
+    D.Set(1, U.Get(1) + V.Get(1));
+
+    std::vector<float> e12(count), e13(count), e23(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto B = Vec_Wedge(U.Get(i), V.Get(i));
+        e12[i] = B.e12;
+        e13[i] = B.e13;
+        e23[i] = B.e23;
+    }
+
+    std::vector<float>   t(count);
+    std::vector<uint8_t> hit(count);
+    auto hits = Intersect_RayPlane(O.SoA(), D.SoA(), P.SoA(), { e12.data(), e13.data(), e23.data() },
+                                   count, 10.0f, t.data(), hit.data(), 3);
+
+    assert(hit[0] == 1 && fabsf(t[0] - 1.0f) < 1e-6f);
+    assert(hit[1] == 0);
+
+    size_t expected_hits = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        expected_hits += hit[i];
+
+        // Cross-check against the normal form (P - O).n / D.n.
+        auto n  = Cross(U.Get(i), V.Get(i));
+        auto dn = Vec_Dot(D.Get(i), n);
+        if (fabsf(dn) < 1e-3f)
+        {
+            continue;
+        }
+        auto ref = Vec_Dot(P.Get(i) - O.Get(i), n) / dn;
+        assert(fabsf(ref - t[i]) < 1e-3f * (1.0f + fabsf(ref)));
+        if (ref > 1e-3f && ref < 10.0f - 1e-3f)
+        {
+            assert(hit[i] == 1);
+        }
+        if (ref < -1e-3f || ref > 10.0f + 1e-3f)
+        {
+            assert(hit[i] == 0);
+        }
+    }
+    assert(hits == expected_hits);
+}
+
+
+void
+Test_LineLine()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 1002;
+
+    Vecs P1(count), D1(count), P2(count), D2(count), X1(count), X2(count);
+    P1.Randomise();
+    D1.Randomise();
+    P2.Randomise();
+    D2.Randomise();
+
+    // Line 0: the x axis against a line parallel to y through (3, 0, 1).
+    P1.Set(0, { 0, 0, 0 });
+    D1.Set(0, { 1, 0, 0 });
+    P2.Set(0, { 3, 7, 1 });
+    D2.Set(0, { 0, 1, 0 });
+
+    // Line 1: parallel lines.
+    D2.Set(1, D1.Get(1) * 2.0f);
+
+    std::vector<uint8_t> hit(count);
+    Intersect_LineLine(P1.SoA(), D1.SoA(), P2.SoA(), D2.SoA(), count, 1.5f, X1.SoA(), X2.SoA(), hit.data(), 2);
+
+    auto x1 = X1.Get(0);
+    auto x2 = X2.Get(0);
+    assert(fabsf(x1.x - 3) < 1e-5f && fabsf(x1.y) < 1e-5f && fabsf(x1.z) < 1e-5f);
+    assert(fabsf(x2.x - 3) < 1e-5f && fabsf(x2.y) < 1e-5f && fabsf(x2.z - 1) < 1e-5f);
+    assert(hit[0] == 1);
+    assert(hit[1] == 0);
+
+    // The segment between the closest points is perpendicular to both lines.
+    for (size_t i = 2; i < count; ++i)
+    {
+        auto d = X2.Get(i) - X1.Get(i);
+        assert(fabsf(Vec_Dot(d, D1.Get(i))) < 1e-2f);
+        assert(fabsf(Vec_Dot(d, D2.Get(i))) < 1e-2f);
+    }
+}
+
+
+void
+Test_PointInTriangle()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 1003;
+
+    Vecs P(count), A(count), B(count), C(count);
+    std::vector<int> expected(count);
+
+    // Random points in the plane of random triangles, built from
+    // barycentric coordinates so the answer is known.
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto a = Vec { RandomFloat(), RandomFloat(), RandomFloat() };
+        auto b = Vec { RandomFloat(), RandomFloat(), RandomFloat() };
+        auto c = Vec { RandomFloat(), RandomFloat(), RandomFloat() };
+
+        auto u = RandomFloat() * 0.8f + 0.4f;
+        auto v = RandomFloat() * 0.8f + 0.4f;
+        auto w = 1.0f - u - v;
+
+        expected[i] = u > 0.01f && v > 0.01f && w > 0.01f   ? 1
+                    : u < -0.01f || v < -0.01f || w < -0.01f ? 0
+                                                             : -1;
+
+        // Every third point is lifted off the plane.
+        auto lift = (i % 3 == 0) ? Cross(b - a, c - a) * 0.5f : Vec_Zero();
+        if (i % 3 == 0 && expected[i] == 1)
+        {
+            expected[i] = 0;
+        }
+
+        A.Set(i, a);
+        B.Set(i, b);
+        C.Set(i, c);
+        P.Set(i, a * u + b * v + c * w + lift);
+    }
+
+    std::vector<uint8_t> hit(count);
+    Intersect_PointInTriangle(P.SoA(), A.SoA(), B.SoA(), C.SoA(), count, 1e-3f, hit.data(), 3);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (expected[i] >= 0)
+        {
+            assert(hit[i] == expected[i]);
+        }
+    }
+}
+
+
+int
+main(void)
+{
+    Test_RayPlane();
+    Test_LineLine();
+    Test_PointInTriangle();
+
+    printf("%s PASSED\n", "test_intersection.cpp");
+}
@@ -0,0 +1,216 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/morton.h"
+
+#include <algorithm>
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+struct Points
+{
+    std::vector<float> x, y, z;
+
+    explicit Points(size_t count)
+        : x(count), y(count), z(count)
+    {
+    }
+
+    void
+    Randomise(float extent)
+    {
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            x[i] = extent * RandomFloat();
+            y[i] = extent * RandomFloat();
+            z[i] = extent * RandomFloat();
+        }
+    }
+
+    VecSoA
+    View()
+    {
+        return { x.data(), y.data(), z.data() };
+    }
+
+    Vec
+    operator[](size_t i) const
+    {
+        return { x[i], y[i], z[i] };
+    }
+};
+
+
+void
+Test_Encode()
+{
+    printf(__func__);
+    printf("\n");
+
+    assert(Morton_Encode(0, 0, 0) == 0);
+    assert(Morton_Encode(1, 0, 0) == 1);
+    assert(Morton_Encode(0, 1, 0) == 2);
+    assert(Morton_Encode(0, 0, 1) == 4);
+    assert(Morton_Encode(2, 0, 0) == 8);
+    assert(Morton_Encode(1023, 1023, 1023) == (1u << 30) - 1);
+
+    // Bits beyond 10 are dropped, and de-interleaving recovers each axis.
+    for (int n = 0; n < 1000; ++n)
+    {
+        uint32_t x = rand() & 0x3ff, y = rand() & 0x3ff, z = rand() & 0x3ff;
+        auto     key = Morton_Encode(x | 0x400, y, z);
+
+        uint32_t dx = 0, dy = 0, dz = 0;
+        for (int b = 0; b < 10; ++b)
+        {
+            dx |= ((key >> (3 * b)) & 1) << b;
+            dy |= ((key >> (3 * b + 1)) & 1) << b;
+            dz |= ((key >> (3 * b + 2)) & 1) << b;
+        }
+        assert(dx == x && dy == y && dz == z);
+    }
+}
+
+
+void
+Test_KeysMatchScalar()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 1003;
+    Points       points(count);
+    points.Randomise(10.0f);
+    points.x[5] = 20.0f; // Clamped.
+    points.y[6] = NAN;
+
+    Vec lo = { -10.0f, -10.0f, -10.0f };
+    Vec hi = { 10.0f, 10.0f, 10.0f };
+
+    std::vector<uint32_t> keys(count);
+    Morton_Keys(points.View(), lo, hi, keys.data(), count, 3);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t q[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            auto v = (points[i][k] - lo[k]) * (1024.0f / 20.0f);
+            v      = v > 0.0f ? v : 0.0f;
+            q[k]   = (uint32_t)(v < 1023.0f ? v : 1023.0f);
+        }
+        assert(keys[i] == Morton_Encode(q[0], q[1], q[2]));
+    }
+    assert((keys[5] & 0x09249249) == Morton_Spread(1023));
+    assert((keys[6] & 0x12492492) == 0);
+}
+
+
+void
+Test_SortIsStableAndThreadIndependent()
+{
+    printf(__func__);
+    printf("\n");
+
+    for (size_t count : { (size_t)0, (size_t)1, (size_t)100, (size_t)100003 })
+    {
+        std::vector<uint32_t> keys(count);
+        for (auto& k : keys)
+        {
+            k = (uint32_t)rand() & ((1u << 30) - 1);
+            if (rand() % 4 == 0)
+            {
+                k &= 0xff; // Plenty of duplicates.
+            }
+        }
+
+        std::vector<uint32_t> expected(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            expected[i] = (uint32_t)i;
+        }
+        std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+        for (int threads : { 1, 3, 8 })
+        {
+            auto                  sorted = keys;
+            std::vector<uint32_t> order(count);
+            Morton_Sort(sorted.data(), order.data(), count, threads);
+
+            assert(order == expected);
+            for (size_t i = 0; i < count; ++i)
+            {
+                assert(sorted[i] == keys[order[i]]);
+            }
+        }
+    }
+
+    // Keys that share their top digit skip that pass.
+    std::vector<uint32_t> keys = { 5, 3, 4, 3 }, order(4);
+    Morton_Sort(keys.data(), order.data(), 4, 1);
+    assert(keys[0] == 3 && keys[1] == 3 && keys[3] == 5);
+    assert(order[0] == 1 && order[1] == 3 && order[2] == 2 && order[3] == 0);
+}
+
+
+void
+Test_ReorderImprovesLocality()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 50000;
+    Points       points(count), sorted(count);
+    points.Randomise(100.0f);
+
+    std::vector<uint32_t> order(count), keys(count);
+    Morton_Reorder(points.View(), sorted.View(), order.data(), keys.data(), count, 2);
+
+    // A permutation that moves the points, and the keys come out sorted.
+    std::vector<uint32_t> seen(count, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(order[i] < count && seen[order[i]]++ == 0);
+        assert(Vec_Distance(sorted[i], points[order[i]]) == 0.0f);
+        assert(i == 0 || keys[i - 1] <= keys[i]);
+    }
+
+    // Attributes follow with Morton_Gather.
+    std::vector<int> id(count), moved(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        id[i] = (int)i;
+    }
+    Morton_Gather(id.data(), order.data(), moved.data(), count);
+    assert(moved[123] == (int)order[123]);
+
+    // Consecutive points end up much closer together.
+    double before = 0.0, after = 0.0;
+    for (size_t i = 1; i < count; ++i)
+    {
+        before += Vec_Distance(points[i - 1], points[i]);
+        after += Vec_Distance(sorted[i - 1], sorted[i]);
+    }
+    assert(after * 10.0 < before);
+}
+
+
+int
+main(void)
+{
+    Test_Encode();
+    Test_KeysMatchScalar();
+    Test_SortIsStableAndThreadIndependent();
+    Test_ReorderImprovesLocality();
+
+    printf("%s PASSED\n", "test_morton.cpp");
+}
@@ -0,0 +1,179 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/orientation_buffer.h"
+
+#include <atomic>
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+
+// Every entry of frame k holds the same rotor, with s = k, so a torn read
+// shows up as a mismatch between entries or against the version.
+static void
+FillFrame(OrientationFrame const& frame, uint64_t k)
+{
+    for (size_t i = 0; i < frame.count; ++i)
+    {
+        frame.rotors[i] = Rotor((float)k, (float)i, 0.0f, 0.0f);
+        if (frame.matrices)
+        {
+            for (int j = 0; j < 16; ++j)
+            {
+                frame.matrices[i][j] = (float)k;
+            }
+        }
+    }
+}
+
+
+static bool
+Consistent(OrientationSnapshot const& snapshot)
+{
+    auto k = (float)snapshot.version;
+    for (size_t i = 0; i < snapshot.count; ++i)
+    {
+        if (snapshot.version > 0 && (snapshot.rotors[i].s != k || snapshot.rotors[i].B.e12 != (float)i))
+        {
+            return false;
+        }
+        if (snapshot.version > 0 && snapshot.matrices && snapshot.matrices[i][15] != k)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void
+Test_SnapshotsAreStable()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto b = OrientationBuffer_Create(16, 2, true);
+
+    // Initial frame is identity.
+    auto s0 = OrientationBuffer_Acquire(b);
+    assert(s0.version == 0 && s0.count == 16);
+    assert(s0.rotors[3].s == 1.0f && s0.matrices[3][0] == 1.0f && s0.matrices[3][1] == 0.0f);
+
+    auto f1 = OrientationBuffer_BeginWrite(b);
+    assert(f1.rotors && f1.buffer != s0.buffer);
+    FillFrame(f1, 1);
+    OrientationBuffer_Publish(b, f1);
+
+    // s0 still holds the old frame, and a new reader sees the new one.
+    auto s1 = OrientationBuffer_Acquire(b);
+    assert(s1.version == 1 && s1.buffer == f1.buffer && Consistent(s1));
+    assert(s0.rotors[3].s == 1.0f);
+
+    // With two readers holding two buffers, the writer cycles through the
+    // remaining two and never touches the held ones.
+    for (uint64_t k = 2; k < 10; ++k)
+    {
+        auto f = OrientationBuffer_BeginWrite(b);
+        assert(f.rotors && f.buffer != s0.buffer && f.buffer != s1.buffer);
+        FillFrame(f, k);
+        OrientationBuffer_Publish(b, f);
+    }
+    assert(s0.version == 0 && s0.rotors[3].s == 1.0f);
+    assert(s1.version == 1 && Consistent(s1));
+
+    // Going over the reader limit can starve the writer: with three
+    // snapshots held and a fourth buffer published, none is left.
+    auto s2 = OrientationBuffer_Acquire(b);
+    assert(s2.version == 9);
+    auto f10 = OrientationBuffer_BeginWrite(b);
+    assert(f10.rotors);
+    FillFrame(f10, 10);
+    OrientationBuffer_Publish(b, f10);
+    assert(OrientationBuffer_BeginWrite(b).rotors == nullptr);
+
+    OrientationBuffer_Release(b, s0);
+    OrientationBuffer_Release(b, s1);
+    OrientationBuffer_Release(b, s2);
+
+    // copy_latest starts from the published frame.
+    auto f = OrientationBuffer_BeginWrite(b, true);
+    assert(f.rotors && f.rotors[5].s == 10.0f && f.matrices[5][15] == 10.0f);
+    f.rotors[5].s = 11.0f;
+    OrientationBuffer_Publish(b, f);
+
+    auto s = OrientationBuffer_Acquire(b);
+    assert(s.version == 11 && s.rotors[5].s == 11.0f && s.rotors[4].s == 10.0f);
+    OrientationBuffer_Release(b, s);
+
+    OrientationBuffer_Destroy(b);
+}
+
+
+void
+Test_ConcurrentReaders()
+{
+    printf(__func__);
+    printf("\n");
+
+    int const      readers = 3;
+    size_t const   count   = 1000;
+    uint64_t const frames  = 2000;
+
+    auto b = OrientationBuffer_Create(count, readers, true);
+
+    std::atomic<bool>        done(false);
+    std::atomic<int>         failures(0);
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&]() {
+            uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire))
+            {
+                auto s = OrientationBuffer_Acquire(b);
+                if (s.version < last || !Consistent(s))
+                {
+                    failures.fetch_add(1);
+                }
+                last = s.version;
+                OrientationBuffer_Release(b, s);
+            }
+        });
+    }
+
+    // With max_readers + 2 buffers and one snapshot per reader, the writer
+    // never has to wait.
+    for (uint64_t k = 1; k <= frames; ++k)
+    {
+        auto f = OrientationBuffer_BeginWrite(b);
+        assert(f.rotors);
+        FillFrame(f, k);
+        OrientationBuffer_Publish(b, f);
+    }
+
+    done.store(true, std::memory_order_release);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    assert(failures.load() == 0);
+
+    auto s = OrientationBuffer_Acquire(b);
+    assert(s.version == frames && Consistent(s));
+    OrientationBuffer_Release(b, s);
+
+    OrientationBuffer_Destroy(b);
+}
+
+
+int
+main(void)
+{
+    Test_SnapshotsAreStable();
+    Test_ConcurrentReaders();
+
+    printf("%s PASSED\n", "test_orientation_buffer.cpp");
+}
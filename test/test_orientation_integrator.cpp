@@ -0,0 +1,172 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/orientation_integrator.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+static bool
+Near(Vec const& a, Vec const& b, float eps)
+{
+    return fabsf(a.x - b.x) < eps && fabsf(a.y - b.y) < eps && fabsf(a.z - b.z) < eps;
+}
+
+
+struct Bodies
+{
+    std::vector<float> s, r12, r13, r23;
+    std::vector<float> w12, w13, w23;
+
+    RotorSoA
+    R()
+    {
+        return { s.data(), r12.data(), r13.data(), r23.data() };
+    }
+
+    BiVectorSoA
+    W()
+    {
+        return { w12.data(), w13.data(), w23.data() };
+    }
+
+    Rotor
+    Get(size_t i) const
+    {
+        return Rotor(s[i], r12[i], r13[i], r23[i]);
+    }
+};
+
+
+static Bodies
+RandomBodies(size_t count)
+{
+    Bodies b;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Rotor R(RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+        Geo_Normalise(R);
+        b.s.push_back(R.s);
+        b.r12.push_back(R.B.e12);
+        b.r13.push_back(R.B.e13);
+        b.r23.push_back(R.B.e23);
+        b.w12.push_back(RandomFloat() * 4.0f);
+        b.w13.push_back(RandomFloat() * 4.0f);
+        b.w23.push_back(RandomFloat() * 4.0f);
+    }
+    return b;
+}
+
+
+// Rotor for a rotation of |W| t radians in the plane of W.
+static Rotor
+RotorFromAngularVelocity(float w12, float w13, float w23, float t)
+{
+    auto w = sqrtf(w12 * w12 + w13 * w13 + w23 * w23);
+    auto h = 0.5f * w * t;
+    auto k = w > 0.0f ? -sinf(h) / w : 0.0f;
+    return Rotor(cosf(h), k * w12, k * w13, k * w23);
+}
+
+
+void
+Test_PositiveRateTurnsE1TowardsE2()
+{
+    printf(__func__);
+    printf("\n");
+
+    float s = 1, r12 = 0, r13 = 0, r23 = 0;
+    float w12 = (float)M_PI_2, w13 = 0, w23 = 0;
+
+    auto I = Integrator_Create(IntegratorExp_Exact, 1);
+    Integrator_Step(I, { &s, &r12, &r13, &r23 }, { &w12, &w13, &w23 }, 1, 1.0f);
+
+    auto v = Vec_Rotate(Rotor(s, r12, r13, r23), { 1, 0, 0 });
+    Print("e1 after quarter turn: ", v);
+    assert(Near(v, { 0, 1, 0 }, 1e-5f));
+}
+
+
+void
+Test_ConstantVelocityMatchesClosedForm()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 1003; // Not a multiple of the SIMD width.
+    int const    steps = 100;
+    float const  dt    = 1.0f / 60.0f;
+
+    for (auto mode : { IntegratorExp_Exact, IntegratorExp_Approximate })
+    {
+        srand(1);
+        auto bodies = RandomBodies(count);
+        auto start  = bodies;
+
+        auto I         = Integrator_Create(mode, 8);
+        I.thread_count = 3;
+        for (int i = 0; i < steps; ++i)
+        {
+            Integrator_Step(I, bodies.R(), bodies.W(), count, dt);
+        }
+        assert(I.step == (uint64_t)steps);
+
+        float const eps = mode == IntegratorExp_Exact ? 1e-3f : 5e-3f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto Q = RotorFromAngularVelocity(start.w12[i], start.w13[i], start.w23[i], steps * dt);
+            Vec  v { RandomFloat(), RandomFloat(), RandomFloat() };
+
+            auto expected = Vec_Rotate(Q, Vec_Rotate(start.Get(i), v));
+            auto actual   = Vec_Rotate(bodies.Get(i), v);
+            assert(Near(expected, actual, eps));
+        }
+    }
+}
+
+
+void
+Test_NormaliseCadence()
+{
+    printf(__func__);
+    printf("\n");
+
+    // A non-unit rotor stays non-unit until a renormalising step.
+    float s = 2, r12 = 0, r13 = 0, r23 = 0;
+    float w12 = 0, w13 = 0, w23 = 0;
+
+    auto I = Integrator_Create(IntegratorExp_Exact, 3);
+    Integrator_Step(I, { &s, &r12, &r13, &r23 }, { &w12, &w13, &w23 }, 1, 0.1f);
+    Integrator_Step(I, { &s, &r12, &r13, &r23 }, { &w12, &w13, &w23 }, 1, 0.1f);
+    assert(s == 2.0f);
+    Integrator_Step(I, { &s, &r12, &r13, &r23 }, { &w12, &w13, &w23 }, 1, 0.1f);
+    assert(fabsf(s - 1.0f) < 1e-6f);
+
+    s = 2;
+    I = Integrator_Create(IntegratorExp_Exact, 0);
+    for (int i = 0; i < 10; ++i)
+    {
+        Integrator_Step(I, { &s, &r12, &r13, &r23 }, { &w12, &w13, &w23 }, 1, 0.1f);
+    }
+    assert(s == 2.0f);
+}
+
+
+int
+main(void)
+{
+    Test_PositiveRateTurnsE1TowardsE2();
+    Test_ConstantVelocityMatchesClosedForm();
+    Test_NormaliseCadence();
+
+    printf("%s PASSED\n", "test_orientation_integrator.cpp");
+}
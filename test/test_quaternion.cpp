@@ -0,0 +1,191 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/quaternion.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+static Rotor
+RandomRotor()
+{
+    Rotor R(RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+    Geo_Normalise(R);
+    return R;
+}
+
+
+static bool
+Near(Vec const& a, Vec const& b)
+{
+    auto eps = 1e-5f;
+    return fabsf(a.x - b.x) < eps && fabsf(a.y - b.y) < eps && fabsf(a.z - b.z) < eps;
+}
+
+
+// Hamilton product, written out independently of the library.
+static Quat
+Mul(Quat const& a, Quat const& b)
+{
+    return { a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+             a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+             a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+             a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w };
+}
+
+
+// q v q*
+static Vec
+Rotate(Quat const& q, Vec const& v)
+{
+    auto r = Mul(Mul(q, { 0.0f, v.x, v.y, v.z }), { q.w, -q.x, -q.y, -q.z });
+    return { r.x, r.y, r.z };
+}
+
+
+void
+Test_SignMappingMatchesVecRotate()
+{
+    printf(__func__);
+    printf("\n");
+
+    // A quarter turn about z takes x to y in both conventions.
+    Quat qz = { cosf((float)M_PI / 4.0f), 0.0f, 0.0f, sinf((float)M_PI / 4.0f) };
+    assert(Near(Rotate(qz, { 1.0f, 0.0f, 0.0f }), { 0.0f, 1.0f, 0.0f }));
+    assert(Near(Vec_Rotate(Rotor_FromQuat(qz), { 1.0f, 0.0f, 0.0f }), { 0.0f, 1.0f, 0.0f }));
+
+    for (int n = 0; n < 1000; ++n)
+    {
+        auto R = RandomRotor();
+        auto q = Quat_FromRotor(R);
+        Vec  v = { RandomFloat(), RandomFloat(), RandomFloat() };
+
+        assert(Near(Rotate(q, v), Vec_Rotate(R, v)));
+
+        auto back = Rotor_FromQuat(q);
+        assert(back.s == R.s && back.B.e12 == R.B.e12 && back.B.e13 == R.B.e13 && back.B.e23 == R.B.e23);
+
+        // Quaternion products compose the same way: q1 q2 applies q2 first.
+        auto R2 = RandomRotor();
+        auto q2 = Quat_FromRotor(R2);
+        assert(Near(Rotate(Mul(q, q2), v), Vec_Rotate(R, Vec_Rotate(R2, v))));
+    }
+}
+
+
+struct Body
+{
+    Vec   position;
+    Rotor orientation;
+    float mass;
+};
+
+
+void
+Test_Views()
+{
+    printf(__func__);
+    printf("\n");
+
+    std::vector<Body> bodies(17);
+    for (auto& b : bodies)
+    {
+        b.position    = { RandomFloat(), RandomFloat(), RandomFloat() };
+        b.orientation = RandomRotor();
+        b.mass        = 1.0f;
+    }
+
+    QuatViewWXYZ wxyz(&bodies[0].orientation, bodies.size(), sizeof(Body));
+    QuatViewXYZW xyzw(&bodies[0].orientation, bodies.size(), sizeof(Body));
+
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        auto q = Quat_FromRotor(bodies[i].orientation);
+        assert(wxyz.W(i) == q.w && wxyz.X(i) == q.x && wxyz.Y(i) == q.y && wxyz.Z(i) == q.z);
+
+        float expected_wxyz[4] = { q.w, q.x, q.y, q.z };
+        float expected_xyzw[4] = { q.x, q.y, q.z, q.w };
+        for (int k = 0; k < 4; ++k)
+        {
+            assert(wxyz(i, k) == expected_wxyz[k]);
+            assert(xyzw(i, k) == expected_xyzw[k]);
+        }
+    }
+
+    // Writes go through to the Rotor and leave the neighbours alone.
+    Quat qx = { cosf(0.3f), sinf(0.3f), 0.0f, 0.0f };
+    xyzw.Set(5, qx);
+    assert(bodies[5].orientation.s == qx.w && bodies[5].orientation.B.e23 == -qx.x);
+    assert(bodies[5].mass == 1.0f);
+    assert(Near(Vec_Rotate(bodies[5].orientation, { 0.0f, 1.0f, 0.0f }), Rotate(qx, { 0.0f, 1.0f, 0.0f })));
+
+    // Default stride is a packed Rotor array.
+    std::vector<Rotor> rotors = { RandomRotor(), RandomRotor() };
+    QuatViewWXYZ       packed(rotors.data(), rotors.size());
+    assert(packed(1, 2) == rotors[1].B.e13);
+}
+
+
+void
+Test_BulkConversion()
+{
+    printf(__func__);
+    printf("\n");
+
+    for (size_t count : { (size_t)1, (size_t)2, (size_t)1001 })
+    {
+        std::vector<Rotor> rotors(count);
+        for (auto& R : rotors)
+        {
+            R = RandomRotor();
+        }
+
+        for (auto layout : { QuatLayout_WXYZ, QuatLayout_XYZW })
+        {
+            // Out of place.
+            std::vector<float> packed(4 * count);
+            Quat_FromRotors(rotors.data(), packed.data(), count, layout, 3);
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto  q = Quat_FromRotor(rotors[i]);
+                auto* p = &packed[4 * i];
+                if (layout == QuatLayout_WXYZ)
+                {
+                    assert(p[0] == q.w && p[1] == q.x && p[2] == q.y && p[3] == q.z);
+                }
+                else
+                {
+                    assert(p[0] == q.x && p[1] == q.y && p[2] == q.z && p[3] == q.w);
+                }
+            }
+
+            // In place, there and back, is exact.
+            auto copy = rotors;
+            Quat_FromRotors(copy.data(), &copy[0].s, count, layout, 2);
+            assert(memcmp(&copy[0].s, packed.data(), 4 * count * sizeof(float)) == 0);
+            Quat_ToRotors(&copy[0].s, copy.data(), count, layout, 2);
+            assert(memcmp(copy.data(), rotors.data(), count * sizeof(Rotor)) == 0);
+        }
+    }
+}
+
+
+int
+main(void)
+{
+    Test_SignMappingMatchesVecRotate();
+    Test_Views();
+    Test_BulkConversion();
+
+    printf("%s PASSED\n", "test_quaternion.cpp");
+}
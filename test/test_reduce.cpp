@@ -0,0 +1,208 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/reduce.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+struct Points
+{
+    std::vector<float> x, y, z;
+
+    Points(size_t count, Vec centre, Vec extent)
+        : x(count), y(count), z(count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] = centre.x + extent.x * RandomFloat();
+            y[i] = centre.y + extent.y * RandomFloat();
+            z[i] = centre.z + extent.z * RandomFloat();
+        }
+    }
+
+    VecSoA
+    View()
+    {
+        return { x.data(), y.data(), z.data() };
+    }
+
+    Vec
+    operator[](size_t i) const
+    {
+        return { x[i], y[i], z[i] };
+    }
+};
+
+
+static bool
+Near(float a, float b, float eps)
+{
+    return fabsf(a - b) <= eps;
+}
+
+
+void
+Test_StatsMatchReference()
+{
+    printf(__func__);
+    printf("\n");
+
+    // Far from the origin with a small spread, where a naive float
+    // E[x^2] - E[x]^2 would lose every digit.
+    size_t const count  = 3 * REDUCE_BLOCK + 123;
+    Vec const    centre = { 1000.0f, -2000.0f, 500.0f };
+    Points       points(count, centre, { 1.0f, 2.0f, 0.5f });
+
+    // Reference in double, two passes.
+    double mean[3] = {};
+    double lo[3]   = { 1e30, 1e30, 1e30 };
+    double hi[3]   = { -1e30, -1e30, -1e30 };
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            mean[k] += points[i][k];
+            lo[k] = fmin(lo[k], points[i][k]);
+            hi[k] = fmax(hi[k], points[i][k]);
+        }
+    }
+    for (int k = 0; k < 3; ++k)
+    {
+        mean[k] /= (double)count;
+    }
+
+    double    cov[6] = {};
+    int const row[6] = { 0, 0, 0, 1, 1, 2 };
+    int const col[6] = { 0, 1, 2, 1, 2, 2 };
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (int k = 0; k < 6; ++k)
+        {
+            cov[k] += (points[i][row[k]] - mean[row[k]]) * (points[i][col[k]] - mean[col[k]]);
+        }
+    }
+
+    auto stats = Reduce_Stats(points.View(), count, Reduce_All, 3);
+    assert(stats.count == count);
+    for (int k = 0; k < 3; ++k)
+    {
+        assert(Near(stats.centroid[k], (float)mean[k], 1e-3f));
+        assert(stats.lo[k] == (float)lo[k] && stats.hi[k] == (float)hi[k]);
+    }
+    for (int k = 0; k < 6; ++k)
+    {
+        assert(Near(stats.covariance[k], (float)(cov[k] / (double)count), 1e-4f));
+    }
+
+    // Uniform on [-a, a] has variance a^2 / 3.
+    assert(Near(stats.covariance[0], 1.0f / 3.0f, 0.02f));
+    assert(Near(stats.covariance[3], 4.0f / 3.0f, 0.05f));
+
+    // Flags select what is computed; the rest stays zero.
+    auto bounds = Reduce_Stats(points.View(), count, Reduce_Bounds);
+    assert(bounds.lo.x == stats.lo.x && bounds.hi.z == stats.hi.z);
+    assert(bounds.centroid.x == 0.0f && bounds.covariance[0] == 0.0f);
+
+    auto centroid = Reduce_Stats(points.View(), count, Reduce_Centroid);
+    assert(centroid.centroid.y == stats.centroid.y);
+    assert(centroid.lo.x == 0.0f && centroid.covariance[3] == 0.0f);
+
+    // Small inputs, all in the scalar tail.
+    for (size_t n : { (size_t)1, (size_t)3 })
+    {
+        auto small = Reduce_Stats(points.View(), n);
+        assert(Near(small.centroid.x, n == 1 ? points.x[0] : (points.x[0] + points.x[1] + points.x[2]) / 3.0f, 1e-3f));
+        assert(n > 1 || small.covariance[0] == 0.0f);
+    }
+    assert(Reduce_Stats(points.View(), 0).count == 0);
+}
+
+
+void
+Test_StatsIndependentOfThreads()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 20 * REDUCE_BLOCK + 7;
+    Points       points(count, { 1.0f, 2.0f, 3.0f }, { 10.0f, 10.0f, 10.0f });
+
+    auto reference = Reduce_Stats(points.View(), count, Reduce_All, 1);
+    for (int threads : { 2, 3, 7, 16 })
+    {
+        auto stats = Reduce_Stats(points.View(), count, Reduce_All, threads);
+        assert(memcmp(&stats, &reference, sizeof(stats)) == 0);
+    }
+}
+
+
+void
+Test_RotatedBounds()
+{
+    printf(__func__);
+    printf("\n");
+
+    size_t const count = 2 * REDUCE_BLOCK + 5;
+    Points       points(count, { 3.0f, -1.0f, 2.0f }, { 2.0f, 0.5f, 1.0f });
+
+    for (int n = 0; n < 10; ++n)
+    {
+        Rotor R(RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+        Geo_Normalise(R);
+
+        Vec lo = Vec_Rotate(R, points[0]), hi = lo;
+        for (size_t i = 1; i < count; ++i)
+        {
+            auto v = Vec_Rotate(R, points[i]);
+            for (int k = 0; k < 3; ++k)
+            {
+                lo[k] = fminf(lo[k], v[k]);
+                hi[k] = fmaxf(hi[k], v[k]);
+            }
+        }
+
+        Vec exact_lo, exact_hi;
+        Reduce_RotatedBounds(R, points.View(), count, exact_lo, exact_hi, 2);
+
+        auto stats = Reduce_Stats(points.View(), count, Reduce_Bounds);
+        Vec  box_lo, box_hi;
+        Reduce_RotatedBox(R, stats.lo, stats.hi, box_lo, box_hi);
+
+        for (int k = 0; k < 3; ++k)
+        {
+            assert(Near(exact_lo[k], lo[k], 1e-4f) && Near(exact_hi[k], hi[k], 1e-4f));
+            assert(box_lo[k] <= exact_lo[k] + 1e-4f && box_hi[k] >= exact_hi[k] - 1e-4f);
+        }
+    }
+
+    // A quarter turn maps the box onto a box, so the cheap bound is exact.
+    Rotor quarter(cosf((float)M_PI / 4.0f), -sinf((float)M_PI / 4.0f), 0.0f, 0.0f);
+    Vec   box_lo, box_hi;
+    Reduce_RotatedBox(quarter, { 1.0f, 2.0f, 3.0f }, { 2.0f, 4.0f, 6.0f }, box_lo, box_hi);
+    auto a = Vec_Rotate(quarter, { 1.0f, 0.0f, 0.0f });
+    assert(Near(fabsf(a.y), 1.0f, 1e-6f));
+    assert(Near(box_hi.x - box_lo.x, 2.0f, 1e-5f) && Near(box_hi.y - box_lo.y, 1.0f, 1e-5f));
+    assert(Near(box_hi.z - box_lo.z, 3.0f, 1e-5f));
+}
+
+
+int
+main(void)
+{
+    Test_StatsMatchReference();
+    Test_StatsIndependentOfThreads();
+    Test_RotatedBounds();
+
+    printf("%s PASSED\n", "test_reduce.cpp");
+}
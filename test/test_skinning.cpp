@@ -0,0 +1,299 @@
+#include "GeometricAlgebra/geometric_algebra.h"
+#include "GeometricAlgebra/quaternion.h"
+#include "GeometricAlgebra/skinning.h"
+
+#include <cassert>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+
+static float
+RandomFloat()
+{
+    return rand() / (float)RAND_MAX * 2.0f - 1.0f;
+}
+
+
+static bool
+Near(Vec const& a, Vec const& b)
+{
+    auto eps = 1e-4f;
+    return fabsf(a.x - b.x) < eps && fabsf(a.y - b.y) < eps && fabsf(a.z - b.z) < eps;
+}
+
+
+struct Mesh
+{
+    std::vector<float>    x, y, z;
+    std::vector<float>    ox, oy, oz;
+    std::vector<uint16_t> bone;
+    std::vector<float>    weight;
+    int                   per_vertex;
+
+    Mesh(size_t count, int K, size_t bone_count)
+        : x(count), y(count), z(count), ox(count), oy(count), oz(count),
+          bone(count * K), weight(count * K), per_vertex(K)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] = RandomFloat();
+            y[i] = RandomFloat();
+            z[i] = RandomFloat();
+
+            float total = 0.0f;
+            for (int k = 0; k < K; ++k)
+            {
+                bone[i * K + k]   = (uint16_t)(rand() % bone_count);
+                weight[i * K + k] = RandomFloat() + 1.0f;
+                total += weight[i * K + k];
+            }
+            for (int k = 0; k < K; ++k)
+            {
+                weight[i * K + k] /= total;
+            }
+        }
+    }
+
+    VecSoA
+    In()
+    {
+        return { x.data(), y.data(), z.data() };
+    }
+
+    VecSoA
+    Out()
+    {
+        return { ox.data(), oy.data(), oz.data() };
+    }
+
+    SkinInfluences
+    Influences() const
+    {
+        return { bone.data(), weight.data(), per_vertex };
+    }
+
+    Vec
+    Position(size_t i) const
+    {
+        return { x[i], y[i], z[i] };
+    }
+
+    Vec
+    Skinned(size_t i) const
+    {
+        return { ox[i], oy[i], oz[i] };
+    }
+};
+
+
+static std::vector<SkinBone>
+RandomBones(size_t count)
+{
+    std::vector<SkinBone> bones(count);
+    for (auto& b : bones)
+    {
+        b.R = Rotor(RandomFloat(), RandomFloat(), RandomFloat(), RandomFloat());
+        Geo_Normalise(b.R);
+        b.t = { RandomFloat(), RandomFloat(), RandomFloat() };
+    }
+    return bones;
+}
+
+
+void
+Test_LinearMatchesPerBoneRotate()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto bones = RandomBones(32);
+    std::vector<SkinMatrix> matrices(bones.size());
+    Skin_PrepareMatrices(bones.data(), bones.size(), matrices.data());
+
+    for (int K : { 1, 4, 8 })
+    {
+        Mesh mesh(1003, K, bones.size());
+        Skin_Linear(matrices.data(), mesh.In(), mesh.Influences(), mesh.Out(), 1003, 3);
+
+        for (size_t i = 0; i < 1003; ++i)
+        {
+            auto expected = Vec_Zero();
+            for (int k = 0; k < K; ++k)
+            {
+                auto const& b = bones[mesh.bone[i * K + k]];
+                expected += (Vec_Rotate(b.R, mesh.Position(i)) + b.t) * mesh.weight[i * K + k];
+            }
+            assert(Near(expected, mesh.Skinned(i)));
+        }
+    }
+}
+
+
+void
+Test_RotorBlend()
+{
+    printf(__func__);
+    printf("\n");
+
+    auto bones = RandomBones(32);
+
+    // A single influence is a rigid transform.
+    {
+        Mesh mesh(1001, 1, bones.size());
+        Skin_Rotor(bones.data(), mesh.In(), mesh.Influences(), mesh.Out(), 1001, 2);
+        for (size_t i = 0; i < 1001; ++i)
+        {
+            auto const& b = bones[mesh.bone[i]];
+            assert(Near(Vec_Rotate(b.R, mesh.Position(i)) + b.t, mesh.Skinned(i)));
+        }
+    }
+
+    // Opposite-signed rotors for the same rotation blend to that rotation,
+    // where a naive sum would cancel.
+    {
+        bones[1].R = Rotor(-bones[0].R.s, -bones[0].R.B.e12, -bones[0].R.B.e13, -bones[0].R.B.e23);
+        bones[1].t = bones[0].t;
+
+        Mesh mesh(17, 2, 2);
+        for (size_t i = 0; i < 17; ++i)
+        {
+            mesh.bone[2 * i]       = 0;
+            mesh.bone[2 * i + 1]   = 1;
+            mesh.weight[2 * i]     = 0.5f;
+            mesh.weight[2 * i + 1] = 0.5f;
+        }
+        Skin_Rotor(bones.data(), mesh.In(), mesh.Influences(), mesh.Out(), 17, 1);
+        for (size_t i = 0; i < 17; ++i)
+        {
+            assert(Near(Vec_Rotate(bones[0].R, mesh.Position(i)) + bones[0].t, mesh.Skinned(i)));
+        }
+    }
+
+    // Blended vertices keep their distance from the bone origin under a
+    // pure twist, unlike linear blending.
+    {
+        SkinBone twist[2];
+        twist[0].R = Rotor();
+        twist[0].t = Vec_Zero();
+        twist[1].R = Rotor(cosf(1.4f), 0.0f, 0.0f, sinf(1.4f)); // ~160 degrees about x.
+        twist[1].t = Vec_Zero();
+
+        Mesh mesh(8, 2, 2);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            mesh.bone[2 * i]       = 0;
+            mesh.bone[2 * i + 1]   = 1;
+            mesh.weight[2 * i]     = 0.5f;
+            mesh.weight[2 * i + 1] = 0.5f;
+        }
+        Skin_Rotor(twist, mesh.In(), mesh.Influences(), mesh.Out(), 8, 1);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            assert(fabsf(Vec_Magnitude(mesh.Position(i)) - Vec_Magnitude(mesh.Skinned(i))) < 1e-4f);
+        }
+    }
+}
+
+
+// Dual quaternion linear blending (Kavan et al.), written with Hamilton
+// quaternions rather than the library's rotor algebra.
+static Quat
+QMul(Quat const& a, Quat const& b)
+{
+    return { a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+             a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+             a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+             a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w };
+}
+
+
+static Vec
+DualQuaternionBlend(SkinBone const* bones, uint16_t const* bone, float const* weight, int K, Vec const& p)
+{
+    auto q0 = Quat_FromRotor(bones[bone[0]].R);
+    Quat Q  = { 0, 0, 0, 0 };
+    Quat D  = { 0, 0, 0, 0 };
+    for (int k = 0; k < K; ++k)
+    {
+        auto q = Quat_FromRotor(bones[bone[k]].R);
+        auto t = bones[bone[k]].t;
+        auto d = QMul({ 0.0f, 0.5f * t.x, 0.5f * t.y, 0.5f * t.z }, q);
+        auto w = weight[k];
+        if (q0.w * q.w + q0.x * q.x + q0.y * q.y + q0.z * q.z < 0.0f)
+        {
+            w = -w;
+        }
+        Q = { Q.w + w * q.w, Q.x + w * q.x, Q.y + w * q.y, Q.z + w * q.z };
+        D = { D.w + w * d.w, D.x + w * d.x, D.y + w * d.y, D.z + w * d.z };
+    }
+
+    auto n = sqrtf(Q.w * Q.w + Q.x * Q.x + Q.y * Q.y + Q.z * Q.z);
+    Q      = { Q.w / n, Q.x / n, Q.y / n, Q.z / n };
+    D      = { D.w / n, D.x / n, D.y / n, D.z / n };
+
+    auto t = QMul(D, { Q.w, -Q.x, -Q.y, -Q.z });
+    auto r = QMul(QMul(Q, { 0.0f, p.x, p.y, p.z }), { Q.w, -Q.x, -Q.y, -Q.z });
+    return { r.x + 2.0f * t.x, r.y + 2.0f * t.y, r.z + 2.0f * t.z };
+}
+
+
+void
+Test_RotorBlendMatchesDualQuaternions()
+{
+    printf(__func__);
+    printf("\n");
+
+    // Bones pivoting about a point off the origin: t = c - R c. A vertex at
+    // the pivot must stay there under any blend, as it does with Skin_Linear.
+    {
+        Vec      c = { 0.0f, 1.0f, 0.0f };
+        SkinBone pivot[2];
+        pivot[0].R = Rotor();
+        pivot[0].t = Vec_Zero();
+        pivot[1].R = Rotor(cosf(1.4f), 0.0f, 0.0f, sinf(1.4f)); // ~160 degrees about x.
+        pivot[1].t = c - Vec_Rotate(pivot[1].R, c);
+
+        Mesh mesh(5, 2, 2);
+        for (size_t i = 0; i < 5; ++i)
+        {
+            mesh.x[i]              = c.x;
+            mesh.y[i]              = c.y;
+            mesh.z[i]              = c.z;
+            mesh.bone[2 * i]       = 0;
+            mesh.bone[2 * i + 1]   = 1;
+            mesh.weight[2 * i]     = 0.5f;
+            mesh.weight[2 * i + 1] = 0.5f;
+        }
+        Skin_Rotor(pivot, mesh.In(), mesh.Influences(), mesh.Out(), 5, 1);
+        for (size_t i = 0; i < 5; ++i)
+        {
+            assert(Near(mesh.Skinned(i), c));
+        }
+    }
+
+    // Random rigs with translations, through both the SSE and scalar paths.
+    auto bones = RandomBones(32);
+    for (int K : { 4, 8 })
+    {
+        Mesh mesh(1003, K, bones.size());
+        Skin_Rotor(bones.data(), mesh.In(), mesh.Influences(), mesh.Out(), 1003, 3);
+        for (size_t i = 0; i < 1003; ++i)
+        {
+            auto expected = DualQuaternionBlend(bones.data(), &mesh.bone[i * K], &mesh.weight[i * K], K, mesh.Position(i));
+            assert(Near(expected, mesh.Skinned(i)));
+        }
+    }
+}
+
+
+int
+main(void)
+{
+    Test_LinearMatchesPerBoneRotate();
+    Test_RotorBlend();
+    Test_RotorBlendMatchesDualQuaternions();
+
+    printf("%s PASSED\n", "test_skinning.cpp");
+}